@@ -19,14 +19,20 @@
 
 #include "Mixer/MixerNull.h"
 #include "Mixer/MixerSDL.h"
+#include "Renderer/GLStateCache.h"
 #include "Renderer/RendererOpenGL.h"
 #include "Renderer/RendererNull.h"
+#include "Renderer/RendererPipelined.h"
+#include "Resource/TextureAtlas.h"
+#include "Resource/TextureCache.h"
+#include "Resource/TextureUploadQueue.h"
 
 #include <SDL2/SDL.h>
 
 #include <stdexcept>
 #include <string>
 #include <map>
+#include <memory>
 
 
 using namespace NAS2D;
@@ -42,6 +48,9 @@ namespace
 			{"bitdepth", 32},
 			{"fullscreen", false},
 			{"vsync", true},
+			{"coreprofile", false},
+			{"pipelined", false},
+			{"texturecache", false},
 		}};
 	}
 
@@ -76,8 +85,10 @@ namespace
  * \param	organizationName	The name of the organization (used to create an app data write path)
  * \param	configPath	Path to the Config file. Defaults to 'config.xml'.
  * \param	dataPath	Initial data path. Defaults to 'data'.
+ * \param	allowPipelinedRenderer	Lets the 'pipelined' graphics option draw on a render thread.
+ *			Only pass true if every State follows the rules in RendererPipelined.
  */
-Application::Application(const std::string& title, const std::string& appName, const std::string& organizationName, const std::string& configPath, const std::string& dataPath)
+Application::Application(const std::string& title, const std::string& appName, const std::string& organizationName, const std::string& configPath, const std::string& dataPath, bool allowPipelinedRenderer)
 {
 	SDL_Init(0);
 
@@ -91,8 +102,25 @@ Application::Application(const std::string& title, const std::string& appName, c
 
 	Utility<EventHandler>::get();
 
+	if (configuration["graphics"].get<bool>("texturecache", false))
+	{
+		Utility<TextureCache>::init(RealPath{(fs.prefPath() / RealPath{"TextureCache"}).string()});
+	}
+
 	const auto rendererOptions = RendererOpenGL::ReadConfigurationOptions(configuration);
-	Utility<Renderer>::init<RendererOpenGL>(title, rendererOptions);
+	auto pipelined = allowPipelinedRenderer && configuration["graphics"].get<bool>("pipelined", false);
+#if defined(__APPLE__)
+	// The OpenGL context must stay on the main thread on macOS
+	pipelined = false;
+#endif
+	if (pipelined)
+	{
+		Utility<Renderer>::init<RendererPipelined>(std::make_unique<RendererOpenGL>(title, rendererOptions));
+	}
+	else
+	{
+		Utility<Renderer>::init<RendererOpenGL>(title, rendererOptions);
+	}
 
 	try
 	{
@@ -113,7 +141,13 @@ Application::~Application()
 {
 	// Destroy all of our various components in reverse order.
 	Utility<Mixer>::clear();
+	// Atlas pages and upload buffers belong to the renderer's context
+	Utility<TextureUploadQueue>::clear();
+	Utility<TextureAtlas>::clear();
 	Utility<Renderer>::clear();
+	// Cleared last of the graphics objects, since their destructors use it
+	Utility<GLStateCache>::clear();
+	Utility<TextureCache>::clear();
 	Utility<EventHandler>::clear();
 	Utility<Configuration>::clear();
 	Utility<Filesystem>::clear();
@@ -159,6 +193,7 @@ void Application::mountFindFromBase(const std::string& path)
 void Application::go(State* state)
 {
 	StateManager stateManager;
+	stateManager.finishRenderingOnStateChange(true);
 
 	stateManager.setState(state);
 
@@ -167,6 +202,9 @@ void Application::go(State* state)
 	{
 		Utility<Renderer>::get().update();
 	}
+
+	// The last state's resources may still be in use by a pipelined renderer
+	Utility<Renderer>::get().finish();
 }
 
 
@@ -57,7 +57,7 @@ namespace NAS2D
 	class Application
 	{
 	public:
-		Application(const std::string& title, const std::string& appName, const std::string& organizationName, const std::string& configPath = "config.xml", const std::string& dataPath = "data");
+		Application(const std::string& title, const std::string& appName, const std::string& organizationName, const std::string& configPath = "config.xml", const std::string& dataPath = "data", bool allowPipelinedRenderer = false);
 		~Application();
 
 		void mount(const std::string& path);
@@ -16,6 +16,7 @@
 #include <SDL2/SDL_filesystem.h>
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <limits>
@@ -344,6 +345,44 @@ void Filesystem::del(const VirtualPath& filename)
 }
 
 
+/**
+ * Gets the size in bytes of a file.
+ *
+ * \param	filename	Path of the file, relative to the search path.
+ */
+std::uintmax_t Filesystem::fileSize(const VirtualPath& filename) const
+{
+	const auto& filePath = findFirstPath(filename, mSearchPaths);
+	if (filePath.empty())
+	{
+		throw std::runtime_error("Error opening file: " + filename.string() + " : File does not exist");
+	}
+
+	return std::filesystem::file_size(filePath);
+}
+
+
+/**
+ * Gets the time a file was last written, for detecting changes between runs.
+ *
+ * Times are in nanoseconds from a platform defined epoch, and are only
+ * meaningful compared to each other.
+ *
+ * \param	filename	Path of the file, relative to the search path.
+ */
+std::int64_t Filesystem::modificationTime(const VirtualPath& filename) const
+{
+	const auto& filePath = findFirstPath(filename, mSearchPaths);
+	if (filePath.empty())
+	{
+		throw std::runtime_error("Error opening file: " + filename.string() + " : File does not exist");
+	}
+
+	const auto sinceEpoch = std::filesystem::last_write_time(filePath).time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+}
+
+
 std::string Filesystem::readFile(const VirtualPath& filename) const
 {
 	const auto& filePath = findFirstPath(filename, mSearchPaths);
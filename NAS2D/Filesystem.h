@@ -12,6 +12,7 @@
 
 #include "FilesystemPath.h"
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -60,6 +61,9 @@ namespace NAS2D
 		bool exists(const VirtualPath& path) const;
 		void del(const VirtualPath& path);
 
+		std::uintmax_t fileSize(const VirtualPath& filename) const;
+		std::int64_t modificationTime(const VirtualPath& filename) const;
+
 		std::string readFile(const VirtualPath& filename) const;
 		void writeFile(const VirtualPath& filename, const std::string& data, WriteFlags flags = WriteFlags::Overwrite);
 
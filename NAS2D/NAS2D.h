@@ -28,6 +28,7 @@
 #include "StringTo.h"
 #include "StringUtils.h"
 #include "StringValue.h"
+#include "ThreadPool.h"
 #include "Timer.h"
 #include "Utility.h"
 #include "Version.h"
@@ -49,19 +50,37 @@
 #include "Renderer/Color.h"
 #include "Renderer/DisplayDesc.h"
 #include "Renderer/Fade.h"
+#include "Renderer/GLStateCache.h"
+#include "Renderer/ImageInstance.h"
+#include "Renderer/ImageResample.h"
 #include "Renderer/RectangleSkin.h"
+#include "Renderer/RenderLayer.h"
+#include "Renderer/RenderQueue.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/RendererNull.h"
+#include "Renderer/PixelBlend.h"
 #include "Renderer/RendererOpenGL.h"
+#include "Renderer/RendererPipelined.h"
+#include "Renderer/RendererRecording.h"
+#include "Renderer/RendererSoftware.h"
+#include "Renderer/TextMesh.h"
+#include "Renderer/TileMapLayer.h"
+#include "Renderer/Vertex.h"
 #include "Renderer/Window.h"
 
 #include "Resource/AnimationSet.h"
+#include "Resource/CollisionMask.h"
 #include "Resource/Font.h"
 #include "Resource/Image.h"
 #include "Resource/Music.h"
+#include "Resource/PixelView.h"
 #include "Resource/ResourceCache.h"
+#include "Resource/SkylinePacker.h"
 #include "Resource/Sound.h"
 #include "Resource/Sprite.h"
+#include "Resource/TextureAtlas.h"
+#include "Resource/TextureCache.h"
+#include "Resource/TextureUploadQueue.h"
 
 #include "Signal/Delegate.h"
 #include "Signal/Signal.h"
@@ -0,0 +1,277 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "GLStateCache.h"
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#else
+#include <GL/glew.h>
+#endif
+
+
+using namespace NAS2D;
+
+
+/**
+ * Forgets all cached state. Use after the context is created, or after state has
+ * been changed without going through the cache.
+ */
+void GLStateCache::invalidate()
+{
+	mCapabilities.clear();
+	mClientStates.clear();
+	mBoundTexture.reset();
+	mTextureWraps.clear();
+	mBoundBuffers.clear();
+	mBoundFramebuffer.reset();
+	mScissor.reset();
+	mClearColor.reset();
+}
+
+
+void GLStateCache::enable(unsigned int capability)
+{
+	setCapability(capability, true);
+}
+
+
+void GLStateCache::disable(unsigned int capability)
+{
+	setCapability(capability, false);
+}
+
+
+void GLStateCache::enableClientState(unsigned int array)
+{
+	setClientState(array, true);
+}
+
+
+void GLStateCache::disableClientState(unsigned int array)
+{
+	setClientState(array, false);
+}
+
+
+void GLStateCache::bindTexture(unsigned int textureId)
+{
+	if (update(mBoundTexture, textureId))
+	{
+		++mTextureBinds;
+		glBindTexture(GL_TEXTURE_2D, textureId);
+	}
+}
+
+
+/**
+ * Deletes a texture and forgets any state cached for its name, which
+ * OpenGL is free to hand out again.
+ */
+void GLStateCache::deleteTexture(unsigned int textureId)
+{
+	if (textureId == 0 || deferDelete(ObjectType::Texture, textureId)) { return; }
+
+	deleteObject(ObjectType::Texture, textureId);
+}
+
+
+/**
+ * Sets the wrap mode of a texture, binding it if needed.
+ */
+void GLStateCache::textureWrap(unsigned int textureId, TextureWrap wrap)
+{
+	if (update(mTextureWraps[textureId], wrap))
+	{
+		bindTexture(textureId);
+		const auto mode = (wrap == TextureWrap::Repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, mode);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, mode);
+	}
+}
+
+
+void GLStateCache::bindBuffer(unsigned int target, unsigned int bufferId)
+{
+	if (update(mBoundBuffers[target], bufferId))
+	{
+		glBindBuffer(target, bufferId);
+	}
+}
+
+
+void GLStateCache::deleteBuffer(unsigned int bufferId)
+{
+	if (bufferId == 0 || deferDelete(ObjectType::Buffer, bufferId)) { return; }
+
+	deleteObject(ObjectType::Buffer, bufferId);
+}
+
+
+void GLStateCache::bindFramebuffer(unsigned int framebufferId)
+{
+	if (update(mBoundFramebuffer, framebufferId))
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	}
+}
+
+
+void GLStateCache::deleteFramebuffer(unsigned int framebufferId)
+{
+	if (framebufferId == 0 || deferDelete(ObjectType::Framebuffer, framebufferId)) { return; }
+
+	deleteObject(ObjectType::Framebuffer, framebufferId);
+}
+
+
+/**
+ * Sets the thread the context is current on, or std::thread::id{} if none.
+ *
+ * Deletes from other threads are queued until flushDeletes() is called with
+ * the context held. Until this is first called, deletes are never queued.
+ */
+void GLStateCache::contextThread(std::thread::id threadId)
+{
+	std::lock_guard lock{mDeleteMutex};
+	mContextThread = threadId;
+}
+
+
+/**
+ * Runs deletes queued by threads not holding the context. Call only while
+ * holding the context.
+ */
+void GLStateCache::flushDeletes()
+{
+	std::vector<std::pair<ObjectType, unsigned int>> deletes;
+	{
+		std::lock_guard lock{mDeleteMutex};
+		deletes.swap(mDeferredDeletes);
+	}
+
+	for (const auto& [type, objectId] : deletes)
+	{
+		deleteObject(type, objectId);
+	}
+}
+
+
+/**
+ * Sets the scissor box. Coordinates are in window space, origin bottom left.
+ */
+void GLStateCache::scissor(const Rectangle<int>& rect)
+{
+	if (update(mScissor, rect))
+	{
+		glScissor(rect.position.x, rect.position.y, rect.size.x, rect.size.y);
+	}
+}
+
+
+void GLStateCache::clearColor(Color color)
+{
+	if (update(mClearColor, color))
+	{
+		glClearColor(static_cast<float>(color.red) / 255.0f, static_cast<float>(color.green) / 255.0f, static_cast<float>(color.blue) / 255.0f, static_cast<float>(color.alpha) / 255.0f);
+	}
+}
+
+
+void GLStateCache::resetCounters()
+{
+	mIssuedCalls = 0;
+	mSkippedCalls = 0;
+	mTextureBinds = 0;
+}
+
+
+/**
+ * Records a new value for a piece of state.
+ *
+ * \return	True if the value changed and the GL call needs to be issued.
+ */
+template <typename T, typename U>
+bool GLStateCache::update(std::optional<T>& cached, const U& value)
+{
+	if (cached && *cached == value)
+	{
+		++mSkippedCalls;
+		return false;
+	}
+
+	cached = value;
+	++mIssuedCalls;
+	return true;
+}
+
+
+void GLStateCache::setCapability(unsigned int capability, bool enabled)
+{
+	if (update(mCapabilities[capability], enabled))
+	{
+		enabled ? glEnable(capability) : glDisable(capability);
+	}
+}
+
+
+void GLStateCache::setClientState(unsigned int array, bool enabled)
+{
+	if (update(mClientStates[array], enabled))
+	{
+		enabled ? glEnableClientState(array) : glDisableClientState(array);
+	}
+}
+
+
+bool GLStateCache::deferDelete(ObjectType type, unsigned int objectId)
+{
+	std::lock_guard lock{mDeleteMutex};
+	if (!mContextThread || *mContextThread == std::this_thread::get_id())
+	{
+		return false;
+	}
+
+	mDeferredDeletes.emplace_back(type, objectId);
+	return true;
+}
+
+
+void GLStateCache::deleteObject(ObjectType type, unsigned int objectId)
+{
+	switch (type)
+	{
+	case ObjectType::Texture:
+		glDeleteTextures(1, &objectId);
+		mTextureWraps.erase(objectId);
+		if (mBoundTexture == objectId)
+		{
+			mBoundTexture = 0u;
+		}
+		break;
+	case ObjectType::Buffer:
+		glDeleteBuffers(1, &objectId);
+		for (auto& [target, boundBuffer] : mBoundBuffers)
+		{
+			if (boundBuffer == objectId)
+			{
+				boundBuffer = 0u;
+			}
+		}
+		break;
+	case ObjectType::Framebuffer:
+		glDeleteFramebuffers(1, &objectId);
+		if (mBoundFramebuffer == objectId)
+		{
+			mBoundFramebuffer = 0u;
+		}
+		break;
+	}
+}
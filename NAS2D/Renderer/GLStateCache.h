@@ -0,0 +1,109 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Math/Rectangle.h"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace NAS2D
+{
+	enum class TextureWrap
+	{
+		ClampToEdge,
+		Repeat,
+	};
+
+
+	/**
+	 * Shadow copy of OpenGL state, used to skip calls that would not change anything.
+	 *
+	 * State starts out unknown, so the first call for each piece of state is always
+	 * issued. All texture, buffer and framebuffer bindings in NAS2D go through here
+	 * so the shadow copy stays in sync with the context.
+	 *
+	 * Once a renderer reports which thread holds the context, deletes from any
+	 * other thread are queued, and run by the next thread to hold the context.
+	 * Resources can then be destroyed while a pipelined renderer draws.
+	 *
+	 * \note	Accessed through Utility<GLStateCache>.
+	 */
+	class GLStateCache
+	{
+	public:
+		void invalidate();
+
+		void enable(unsigned int capability);
+		void disable(unsigned int capability);
+		void enableClientState(unsigned int array);
+		void disableClientState(unsigned int array);
+
+		void bindTexture(unsigned int textureId);
+		void deleteTexture(unsigned int textureId);
+		void textureWrap(unsigned int textureId, TextureWrap wrap);
+
+		void bindBuffer(unsigned int target, unsigned int bufferId);
+		void deleteBuffer(unsigned int bufferId);
+		void bindFramebuffer(unsigned int framebufferId);
+		void deleteFramebuffer(unsigned int framebufferId);
+
+		void contextThread(std::thread::id threadId);
+		void flushDeletes();
+
+		void scissor(const Rectangle<int>& rect);
+		void clearColor(Color color);
+
+		std::size_t issuedCalls() const { return mIssuedCalls; }
+		std::size_t skippedCalls() const { return mSkippedCalls; }
+		std::size_t textureBinds() const { return mTextureBinds; }
+		void resetCounters();
+
+	private:
+		enum class ObjectType
+		{
+			Texture,
+			Buffer,
+			Framebuffer,
+		};
+
+		bool deferDelete(ObjectType type, unsigned int objectId);
+		void deleteObject(ObjectType type, unsigned int objectId);
+
+		template <typename T, typename U>
+		bool update(std::optional<T>& cached, const U& value);
+		void setCapability(unsigned int capability, bool enabled);
+		void setClientState(unsigned int array, bool enabled);
+
+		std::map<unsigned int, std::optional<bool>> mCapabilities{};
+		std::map<unsigned int, std::optional<bool>> mClientStates{};
+		std::optional<unsigned int> mBoundTexture{};
+		std::map<unsigned int, std::optional<TextureWrap>> mTextureWraps{};
+		std::map<unsigned int, std::optional<unsigned int>> mBoundBuffers{};
+		std::optional<unsigned int> mBoundFramebuffer{};
+		std::optional<Rectangle<int>> mScissor{};
+		std::optional<Color> mClearColor{};
+
+		std::size_t mIssuedCalls{0u};
+		std::size_t mSkippedCalls{0u};
+		std::size_t mTextureBinds{0u};
+
+		std::mutex mDeleteMutex{};
+		std::optional<std::thread::id> mContextThread{};
+		std::vector<std::pair<ObjectType, unsigned int>> mDeferredDeletes{};
+	};
+}
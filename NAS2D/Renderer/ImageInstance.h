@@ -0,0 +1,33 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Math/Angle.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+
+
+namespace NAS2D
+{
+	/**
+	 * One copy of an image drawn by Renderer::drawImageInstances.
+	 *
+	 * Each instance draws part of the image the same way as
+	 * Renderer::drawSubImageRotated, rotated about its center.
+	 */
+	struct ImageInstance
+	{
+		Point<float> position;
+		Rectangle<float> subImageRect;
+		Angle angle = Angle::degrees(0);
+		Color color = Color::Normal;
+	};
+}
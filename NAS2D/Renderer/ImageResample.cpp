@@ -0,0 +1,343 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "ImageResample.h"
+
+#include "../ThreadPool.h"
+#include "../Utility.h"
+#include "../StringFrom.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr std::size_t ParallelPixelThreshold = 32 * 1024;
+	constexpr std::size_t Channels = 4;
+
+
+	float boxWeight(float x)
+	{
+		return (x > -0.5f && x <= 0.5f) ? 1.0f : 0.0f;
+	}
+
+
+	float bilinearWeight(float x)
+	{
+		x = std::abs(x);
+		return x < 1.0f ? 1.0f - x : 0.0f;
+	}
+
+
+	float sinc(float x)
+	{
+		if (x == 0.0f) { return 1.0f; }
+		x *= std::numbers::pi_v<float>;
+		return std::sin(x) / x;
+	}
+
+
+	float lanczosWeight(float x)
+	{
+		return std::abs(x) < 3.0f ? sinc(x) * sinc(x / 3.0f) : 0.0f;
+	}
+
+
+	struct Kernel
+	{
+		float support;
+		float (*weight)(float);
+	};
+
+
+	Kernel kernel(ResampleFilter filter)
+	{
+		switch (filter)
+		{
+		case ResampleFilter::Box:
+			return {0.5f, boxWeight};
+		case ResampleFilter::Bilinear:
+			return {1.0f, bilinearWeight};
+		case ResampleFilter::Lanczos:
+			return {3.0f, lanczosWeight};
+		}
+		throw std::runtime_error("Unknown resample filter: " + std::to_string(static_cast<int>(filter)));
+	}
+
+
+	/**
+	 * Source pixels and weights making up each destination pixel along one axis.
+	 *
+	 * Every destination pixel uses the same number of taps, so inner loops have a
+	 * fixed trip count. Windows near an edge are shifted inward rather than cut
+	 * short, and taps outside the filter get a weight of zero.
+	 */
+	struct Contributions
+	{
+		std::size_t tapCount;
+		std::vector<std::size_t> first;
+		std::vector<float> weights;
+	};
+
+
+	Contributions contributions(int sourceLength, int destinationLength, Kernel kernel)
+	{
+		const auto scale = static_cast<float>(sourceLength) / static_cast<float>(destinationLength);
+		const auto filterScale = std::max(scale, 1.0f);
+		const auto support = kernel.support * filterScale;
+		const auto tapCount = std::min(static_cast<int>(std::ceil(support * 2)) + 2, sourceLength);
+
+		Contributions result{static_cast<std::size_t>(tapCount), {}, {}};
+		result.first.reserve(static_cast<std::size_t>(destinationLength));
+		result.weights.reserve(static_cast<std::size_t>(destinationLength * tapCount));
+
+		for (int i = 0; i < destinationLength; ++i)
+		{
+			const auto center = (static_cast<float>(i) + 0.5f) * scale;
+			const auto first = std::clamp(static_cast<int>(std::floor(center - support)), 0, sourceLength - tapCount);
+			const auto weightsStart = result.weights.size();
+
+			auto total = 0.0f;
+			for (int tap = 0; tap < tapCount; ++tap)
+			{
+				const auto weight = kernel.weight((static_cast<float>(first + tap) + 0.5f - center) / filterScale);
+				result.weights.push_back(weight);
+				total += weight;
+			}
+
+			if (total == 0.0f)
+			{
+				// Filter fell between taps; use the nearest source pixel
+				const auto nearest = std::clamp(static_cast<int>(center), first, first + tapCount - 1);
+				result.weights[weightsStart + static_cast<std::size_t>(nearest - first)] = 1.0f;
+				total = 1.0f;
+			}
+
+			for (auto index = weightsStart; index < result.weights.size(); ++index)
+			{
+				result.weights[index] /= total;
+			}
+			result.first.push_back(static_cast<std::size_t>(first));
+		}
+
+		return result;
+	}
+
+
+	/**
+	 * Converts a row of pixels to floats with color channels multiplied by alpha, so
+	 * transparent pixels do not bleed their color into their neighbours.
+	 */
+	void premultiplyRow(std::span<const Color> row, float* output)
+	{
+		for (const auto color : row)
+		{
+			const auto alpha = static_cast<float>(color.alpha) / 255.0f;
+			output[0] = static_cast<float>(color.red) * alpha;
+			output[1] = static_cast<float>(color.green) * alpha;
+			output[2] = static_cast<float>(color.blue) * alpha;
+			output[3] = static_cast<float>(color.alpha);
+			output += Channels;
+		}
+	}
+
+
+	std::uint8_t toChannel(float value)
+	{
+		return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+	}
+
+
+	void unpremultiplyRow(const float* input, std::span<Color> row)
+	{
+		for (auto& color : row)
+		{
+			const auto alpha = std::clamp(input[3], 0.0f, 255.0f);
+			const auto scale = alpha > 0.0f ? 255.0f / alpha : 0.0f;
+			color = {toChannel(input[0] * scale), toChannel(input[1] * scale), toChannel(input[2] * scale), toChannel(alpha)};
+			input += Channels;
+		}
+	}
+
+
+	/**
+	 * Filters one row of premultiplied pixels horizontally.
+	 */
+	void filterRow(const float* input, float* output, const Contributions& columns)
+	{
+		const auto tapCount = columns.tapCount;
+		for (std::size_t x = 0; x < columns.first.size(); ++x)
+		{
+			const auto* pixels = input + columns.first[x] * Channels;
+			const auto* weights = columns.weights.data() + x * tapCount;
+			std::size_t tap = 0;
+
+#if defined(__AVX2__)
+			// Two taps at a time, one pixel per 128 bit lane
+			auto sum256 = _mm256_setzero_ps();
+			for (; tap + 2 <= tapCount; tap += 2)
+			{
+				const auto tapWeights = _mm256_set_m128(_mm_set1_ps(weights[tap + 1]), _mm_set1_ps(weights[tap]));
+				sum256 = _mm256_add_ps(sum256, _mm256_mul_ps(_mm256_loadu_ps(pixels + tap * Channels), tapWeights));
+			}
+			auto sum = _mm_add_ps(_mm256_castps256_ps128(sum256), _mm256_extractf128_ps(sum256, 1));
+#elif defined(__SSE2__) || defined(_M_X64)
+			auto sum = _mm_setzero_ps();
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+			for (; tap < tapCount; ++tap)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixels + tap * Channels), _mm_set1_ps(weights[tap])));
+			}
+			_mm_storeu_ps(output + x * Channels, sum);
+#else
+			float sum[Channels]{};
+			for (; tap < tapCount; ++tap)
+			{
+				for (std::size_t channel = 0; channel < Channels; ++channel)
+				{
+					sum[channel] += pixels[tap * Channels + channel] * weights[tap];
+				}
+			}
+			std::copy(sum, sum + Channels, output + x * Channels);
+#endif
+		}
+	}
+
+
+	/**
+	 * Sums weighted rows of horizontally filtered pixels into one output row.
+	 */
+	void filterColumns(const float* input, std::size_t rowLength, std::size_t firstRow, const float* weights, std::size_t tapCount, float* output)
+	{
+		const auto* rows = input + firstRow * rowLength;
+		std::size_t i = 0;
+
+#if defined(__AVX2__)
+		for (; i + 8 <= rowLength; i += 8)
+		{
+			auto sum = _mm256_setzero_ps();
+			for (std::size_t tap = 0; tap < tapCount; ++tap)
+			{
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows + tap * rowLength + i), _mm256_set1_ps(weights[tap])));
+			}
+			_mm256_storeu_ps(output + i, sum);
+		}
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+		for (; i + 4 <= rowLength; i += 4)
+		{
+			auto sum = _mm_setzero_ps();
+			for (std::size_t tap = 0; tap < tapCount; ++tap)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows + tap * rowLength + i), _mm_set1_ps(weights[tap])));
+			}
+			_mm_storeu_ps(output + i, sum);
+		}
+#endif
+
+		for (; i < rowLength; ++i)
+		{
+			auto sum = 0.0f;
+			for (std::size_t tap = 0; tap < tapCount; ++tap)
+			{
+				sum += rows[tap * rowLength + i] * weights[tap];
+			}
+			output[i] = sum;
+		}
+	}
+
+
+	void forEachRowBand(std::size_t rowCount, std::size_t rowPixels, const std::function<void(std::size_t, std::size_t)>& function)
+	{
+		if (rowCount * rowPixels < ParallelPixelThreshold)
+		{
+			function(0, rowCount);
+		}
+		else
+		{
+			Utility<ThreadPool>::get().parallelFor(rowCount, function);
+		}
+	}
+}
+
+
+/**
+ * Resamples an RGBA pixel buffer to a new size.
+ *
+ * Filtering is separable: rows are filtered horizontally into an intermediate
+ * buffer, which is then filtered vertically. Both passes work in floating point
+ * on premultiplied alpha, and large images have their rows split across the
+ * shared ThreadPool.
+ *
+ * \param source			Rows of source pixels, tightly packed.
+ * \param sourceSize		Size of the source in pixels.
+ * \param destination		Buffer receiving the resampled pixels, tightly packed.
+ * \param destinationSize	Size of the destination in pixels.
+ * \param filter			Filter weighing source pixels.
+ */
+void NAS2D::resample(std::span<const Color> source, Vector<int> sourceSize, std::span<Color> destination, Vector<int> destinationSize, ResampleFilter filter)
+{
+	if (sourceSize.x <= 0 || sourceSize.y <= 0 || destinationSize.x <= 0 || destinationSize.y <= 0)
+	{
+		throw std::runtime_error("Resample sizes must be positive: " + stringFrom(sourceSize) + " to " + stringFrom(destinationSize));
+	}
+
+	const auto sourceWidth = static_cast<std::size_t>(sourceSize.x);
+	const auto sourceHeight = static_cast<std::size_t>(sourceSize.y);
+	const auto destinationWidth = static_cast<std::size_t>(destinationSize.x);
+	const auto destinationHeight = static_cast<std::size_t>(destinationSize.y);
+	if (source.size() < sourceWidth * sourceHeight || destination.size() < destinationWidth * destinationHeight)
+	{
+		throw std::runtime_error("Resample buffer is smaller than its size: " + stringFrom(sourceSize) + " to " + stringFrom(destinationSize));
+	}
+
+	const auto filterKernel = kernel(filter);
+	const auto columns = contributions(sourceSize.x, destinationSize.x, filterKernel);
+	const auto rows = contributions(sourceSize.y, destinationSize.y, filterKernel);
+	const auto rowLength = destinationWidth * Channels;
+
+	std::vector<float> filteredRows(sourceHeight * rowLength);
+	forEachRowBand(sourceHeight, sourceWidth, [&](std::size_t begin, std::size_t end) {
+		std::vector<float> premultiplied(sourceWidth * Channels);
+		for (auto y = begin; y < end; ++y)
+		{
+			premultiplyRow(source.subspan(y * sourceWidth, sourceWidth), premultiplied.data());
+			filterRow(premultiplied.data(), filteredRows.data() + y * rowLength, columns);
+		}
+	});
+
+	forEachRowBand(destinationHeight, destinationWidth, [&](std::size_t begin, std::size_t end) {
+		std::vector<float> outputRow(rowLength);
+		for (auto y = begin; y < end; ++y)
+		{
+			filterColumns(filteredRows.data(), rowLength, rows.first[y], rows.weights.data() + y * rows.tapCount, rows.tapCount, outputRow.data());
+			unpremultiplyRow(outputRow.data(), destination.subspan(y * destinationWidth, destinationWidth));
+		}
+	});
+}
@@ -0,0 +1,34 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Math/Vector.h"
+
+#include <span>
+
+
+namespace NAS2D
+{
+	/**
+	 * Filter used to weigh source pixels when resampling.
+	 *
+	 * When downscaling, filters are widened by the scale factor, so every source
+	 * pixel contributes to the result.
+	 */
+	enum class ResampleFilter
+	{
+		Box,
+		Bilinear,
+		Lanczos,
+	};
+
+	void resample(std::span<const Color> source, Vector<int> sourceSize, std::span<Color> destination, Vector<int> destinationSize, ResampleFilter filter = ResampleFilter::Bilinear);
+}
@@ -0,0 +1,208 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "PixelBlend.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	/**
+	 * Divides by 255, rounding to nearest. Exact for 0 <= value <= 255 * 255.
+	 */
+	constexpr unsigned int divide255(unsigned int value)
+	{
+		const auto rounded = value + 128;
+		return (rounded + (rounded >> 8)) >> 8;
+	}
+
+
+	std::uint8_t blendChannel(std::uint8_t destination, std::uint8_t source, unsigned int alpha)
+	{
+		return static_cast<std::uint8_t>(divide255(source * alpha + destination * (255 - alpha)));
+	}
+
+
+	std::uint8_t modulateChannel(std::uint8_t source, std::uint8_t modulate)
+	{
+		return static_cast<std::uint8_t>(divide255(unsigned{source} * modulate));
+	}
+
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	std::uint32_t toBits(Color color)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &color, sizeof(bits));
+		return bits;
+	}
+
+
+	__m128i divide255(__m128i value)
+	{
+		const auto rounded = _mm_add_epi16(value, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(rounded, _mm_srli_epi16(rounded, 8)), 8);
+	}
+
+
+	/**
+	 * Blends two pixels, unpacked to 16 bits per channel.
+	 */
+	__m128i blendUnpacked(__m128i destination, __m128i source, __m128i modulate)
+	{
+		const auto modulated = divide255(_mm_mullo_epi16(source, modulate));
+		const auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(modulated, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const auto inverseAlpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+		return divide255(_mm_add_epi16(_mm_mullo_epi16(modulated, alpha), _mm_mullo_epi16(destination, inverseAlpha)));
+	}
+
+
+	__m128i blend4(__m128i destination, __m128i source, __m128i modulate)
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto low = blendUnpacked(_mm_unpacklo_epi8(destination, zero), _mm_unpacklo_epi8(source, zero), modulate);
+		const auto high = blendUnpacked(_mm_unpackhi_epi8(destination, zero), _mm_unpackhi_epi8(source, zero), modulate);
+		return _mm_packus_epi16(low, high);
+	}
+
+
+	__m128i unpackedModulate(Color modulate)
+	{
+		return _mm_set_epi16(modulate.alpha, modulate.blue, modulate.green, modulate.red, modulate.alpha, modulate.blue, modulate.green, modulate.red);
+	}
+#endif
+
+
+#if defined(__AVX2__)
+	__m256i divide255(__m256i value)
+	{
+		const auto rounded = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(rounded, _mm256_srli_epi16(rounded, 8)), 8);
+	}
+
+
+	__m256i blendUnpacked(__m256i destination, __m256i source, __m256i modulate)
+	{
+		const auto modulated = divide255(_mm256_mullo_epi16(source, modulate));
+		const auto alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(modulated, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const auto inverseAlpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+		return divide255(_mm256_add_epi16(_mm256_mullo_epi16(modulated, alpha), _mm256_mullo_epi16(destination, inverseAlpha)));
+	}
+
+
+	/**
+	 * Blends eight pixels. Unpacking and packing both work within 128 bit lanes,
+	 * so pixel order is preserved.
+	 */
+	__m256i blend8(__m256i destination, __m256i source, __m256i modulate)
+	{
+		const auto zero = _mm256_setzero_si256();
+		const auto low = blendUnpacked(_mm256_unpacklo_epi8(destination, zero), _mm256_unpacklo_epi8(source, zero), modulate);
+		const auto high = blendUnpacked(_mm256_unpackhi_epi8(destination, zero), _mm256_unpackhi_epi8(source, zero), modulate);
+		return _mm256_packus_epi16(low, high);
+	}
+#endif
+
+
+	/**
+	 * Blends a run of pixels, vectorized where supported.
+	 *
+	 * \param sourceStride	1 to step through \c source, 0 to reuse its first pixel.
+	 */
+	void blendPixels(Color* destination, const Color* source, std::size_t sourceStride, std::size_t count, Color modulate)
+	{
+		std::size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+		const auto modulate128 = unpackedModulate(modulate);
+		const auto constantSource128 = _mm_set1_epi32(static_cast<int>(toBits(source[0])));
+
+#if defined(__AVX2__)
+		const auto modulate256 = _mm256_set_m128i(modulate128, modulate128);
+		const auto constantSource256 = _mm256_set_m128i(constantSource128, constantSource128);
+		for (; i + 8 <= count; i += 8)
+		{
+			auto* destinationPixels = reinterpret_cast<__m256i*>(destination + i);
+			const auto sourcePixels = sourceStride ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)) : constantSource256;
+			_mm256_storeu_si256(destinationPixels, blend8(_mm256_loadu_si256(destinationPixels), sourcePixels, modulate256));
+		}
+#endif
+
+		for (; i + 4 <= count; i += 4)
+		{
+			auto* destinationPixels = reinterpret_cast<__m128i*>(destination + i);
+			const auto sourcePixels = sourceStride ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)) : constantSource128;
+			_mm_storeu_si128(destinationPixels, blend4(_mm_loadu_si128(destinationPixels), sourcePixels, modulate128));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			destination[i] = blendPixel(destination[i], source[i * sourceStride], modulate);
+		}
+	}
+}
+
+
+Color NAS2D::blendPixel(Color destination, Color source, Color modulate)
+{
+	const Color modulated{
+		modulateChannel(source.red, modulate.red),
+		modulateChannel(source.green, modulate.green),
+		modulateChannel(source.blue, modulate.blue),
+		modulateChannel(source.alpha, modulate.alpha),
+	};
+	const unsigned int alpha = modulated.alpha;
+	return {
+		blendChannel(destination.red, modulated.red, alpha),
+		blendChannel(destination.green, modulated.green, alpha),
+		blendChannel(destination.blue, modulated.blue, alpha),
+		blendChannel(destination.alpha, modulated.alpha, alpha),
+	};
+}
+
+
+/**
+ * Blends a row of source pixels over a row of destination pixels.
+ */
+void NAS2D::blendRow(std::span<Color> destination, std::span<const Color> source, Color modulate)
+{
+	if (source.size() < destination.size())
+	{
+		throw std::runtime_error("blendRow source is shorter than destination");
+	}
+	if (destination.empty()) { return; }
+
+	blendPixels(destination.data(), source.data(), 1, destination.size(), modulate);
+}
+
+
+/**
+ * Blends a single color over a row of destination pixels.
+ */
+void NAS2D::blendRow(std::span<Color> destination, Color source)
+{
+	if (destination.empty()) { return; }
+
+	blendPixels(destination.data(), &source, 0, destination.size(), Color::White);
+}
@@ -0,0 +1,30 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+
+#include <span>
+
+
+namespace NAS2D
+{
+	/**
+	 * Alpha blends a color modulated source pixel over a destination pixel.
+	 *
+	 * Matches glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) with the source
+	 * multiplied by \c modulate first. Results are rounded to nearest, and are the
+	 * reference the vectorized row functions are exact against.
+	 */
+	Color blendPixel(Color destination, Color source, Color modulate);
+
+	void blendRow(std::span<Color> destination, std::span<const Color> source, Color modulate);
+	void blendRow(std::span<Color> destination, Color source);
+}
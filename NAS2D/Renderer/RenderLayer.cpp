@@ -0,0 +1,83 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "RenderLayer.h"
+#include "Renderer.h"
+
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+RenderLayer::RenderLayer(Vector<int> size, DrawFunction drawContents) :
+	mImage{size},
+	mDrawContents{std::move(drawContents)}
+{
+}
+
+
+Vector<int> RenderLayer::size() const
+{
+	return mImage.size();
+}
+
+
+const Image& RenderLayer::image() const
+{
+	return mImage;
+}
+
+
+/**
+ * Indicates if the image holds the current contents.
+ */
+bool RenderLayer::isValid() const
+{
+	return mValid;
+}
+
+
+/**
+ * Marks the contents as changed, so they are redrawn the next time the layer is drawn.
+ */
+void RenderLayer::invalidate()
+{
+	mValid = false;
+}
+
+
+/**
+ * Draws the layer, first redrawing its contents if they were invalidated.
+ *
+ * Contents are drawn with pushRenderTarget, so layers can be drawn from within
+ * another layer's contents.
+ */
+void RenderLayer::draw(Renderer& renderer, Point<float> position, Color color)
+{
+	if (!mValid)
+	{
+		renderer.pushRenderTarget(mImage);
+		renderer.clearScreen(Color::NoAlpha);
+		try
+		{
+			mDrawContents(renderer);
+		}
+		catch (...)
+		{
+			renderer.popRenderTarget();
+			throw;
+		}
+		renderer.popRenderTarget();
+		mValid = true;
+	}
+
+	renderer.drawImage(mImage, position, 1.0f, color);
+}
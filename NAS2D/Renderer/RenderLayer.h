@@ -0,0 +1,55 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Resource/Image.h"
+#include "../Math/Point.h"
+#include "../Math/Vector.h"
+
+#include <functional>
+
+
+namespace NAS2D
+{
+	class Renderer;
+
+
+	/**
+	 * Content kept in an offscreen image and redrawn only when invalidated.
+	 *
+	 * Suited to UI panels and other content built from many draws that rarely
+	 * change. The draw function renders the contents into the layer's image,
+	 * in the image's pixel coordinates, starting from a transparent image. Until
+	 * invalidate is called, drawing the layer is a single drawImage.
+	 */
+	class RenderLayer
+	{
+	public:
+		using DrawFunction = std::function<void(Renderer& renderer)>;
+
+		RenderLayer(Vector<int> size, DrawFunction drawContents);
+		RenderLayer(const RenderLayer&) = delete;
+		RenderLayer& operator=(const RenderLayer&) = delete;
+
+		Vector<int> size() const;
+		const Image& image() const;
+
+		bool isValid() const;
+		void invalidate();
+
+		void draw(Renderer& renderer, Point<float> position, Color color = Color::Normal);
+
+	private:
+		Image mImage;
+		DrawFunction mDrawContents;
+		bool mValid{false};
+	};
+}
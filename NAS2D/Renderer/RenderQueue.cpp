@@ -0,0 +1,200 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "RenderQueue.h"
+#include "Renderer.h"
+#include "../Resource/Image.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	Rectangle<float> combined(const Rectangle<float>& a, const Rectangle<float>& b)
+	{
+		const auto start = Point{std::min(a.position.x, b.position.x), std::min(a.position.y, b.position.y)};
+		const auto end = Point{std::max(a.endPoint().x, b.endPoint().x), std::max(a.endPoint().y, b.endPoint().y)};
+		return Rectangle<float>::Create(start, end);
+	}
+}
+
+
+void RenderQueue::drawImage(const Image& image, Point<float> position, int layer, float depth, Color color)
+{
+	const auto imageRect = Rectangle{Point{0.0f, 0.0f}, image.size().to<float>()};
+	mDraws.push_back({DrawType::Image, layer, depth, &image, {position, imageRect.size}, imageRect, Angle::degrees(0), color, 0});
+}
+
+
+void RenderQueue::drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, int layer, float depth, Color color)
+{
+	mDraws.push_back({DrawType::SubImage, layer, depth, &image, {raster, subImageRect.size}, subImageRect, Angle::degrees(0), color, 0});
+}
+
+
+void RenderQueue::drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, int layer, float depth, Color color)
+{
+	mDraws.push_back({DrawType::SubImageRotated, layer, depth, &image, {raster, subImageRect.size}, subImageRect, angle, color, 0});
+}
+
+
+void RenderQueue::drawImageStretched(const Image& image, const Rectangle<float>& rect, int layer, float depth, Color color)
+{
+	const auto imageRect = Rectangle{Point{0.0f, 0.0f}, image.size().to<float>()};
+	mDraws.push_back({DrawType::ImageStretched, layer, depth, &image, rect, imageRect, Angle::degrees(0), color, 0});
+}
+
+
+void RenderQueue::drawBoxFilled(const Rectangle<float>& rect, Color color, int layer, float depth)
+{
+	mDraws.push_back({DrawType::BoxFilled, layer, depth, nullptr, rect, {}, Angle::degrees(0), color, 0});
+}
+
+
+std::size_t RenderQueue::size() const
+{
+	return mDraws.size();
+}
+
+
+bool RenderQueue::empty() const
+{
+	return mDraws.empty();
+}
+
+
+/**
+ * Drops all queued draws without drawing them.
+ */
+void RenderQueue::clear()
+{
+	mDraws.clear();
+}
+
+
+/**
+ * Draws everything queued, in sorted order, and empties the queue.
+ */
+void RenderQueue::flush(Renderer& renderer)
+{
+	sort();
+
+	mBatchCount = 0;
+	const Image* previousImage = nullptr;
+	for (std::size_t i = 0; i < mDraws.size(); ++i)
+	{
+		const auto& draw = mDraws[i];
+		if (i == 0 || draw.image != previousImage)
+		{
+			++mBatchCount;
+			previousImage = draw.image;
+		}
+
+		switch (draw.type)
+		{
+		case DrawType::Image:
+			renderer.drawImage(*draw.image, draw.destination.position, 1.0f, draw.color);
+			break;
+		case DrawType::SubImage:
+			renderer.drawSubImage(*draw.image, draw.destination.position, draw.source, draw.color);
+			break;
+		case DrawType::SubImageRotated:
+			renderer.drawSubImageRotated(*draw.image, draw.destination.position, draw.source, draw.angle, draw.color);
+			break;
+		case DrawType::ImageStretched:
+			renderer.drawImageStretched(*draw.image, draw.destination, draw.color);
+			break;
+		case DrawType::BoxFilled:
+			renderer.drawBoxFilled(draw.destination, draw.color);
+			break;
+		}
+	}
+
+	mDraws.clear();
+}
+
+
+/**
+ * Gets the number of runs of draws sharing an image in the last flush.
+ */
+std::size_t RenderQueue::batchCount() const
+{
+	return mBatchCount;
+}
+
+
+/**
+ * Orders draws by layer and depth, then groups them by image within each layer.
+ *
+ * Each draw joins the most recent batch of its image in the same layer, searching
+ * back no further than the first batch it overlaps. Batch bounds cover all of
+ * their draws, so a draw is only moved ahead of batches it cannot overlap.
+ */
+void RenderQueue::sort()
+{
+	std::stable_sort(mDraws.begin(), mDraws.end(), [](const Draw& a, const Draw& b) {
+		return a.layer < b.layer || (a.layer == b.layer && a.depth < b.depth);
+	});
+
+	mBatches.clear();
+	for (auto& draw : mDraws)
+	{
+		const auto drawBounds = bounds(draw);
+		const auto searchEnd = mBatches.size() > MaxBatchLookback ? mBatches.size() - MaxBatchLookback : 0;
+
+		auto batchIndex = mBatches.size();
+		for (auto i = mBatches.size(); i > searchEnd; --i)
+		{
+			const auto& batch = mBatches[i - 1];
+			if (batch.layer != draw.layer) { break; }
+			if (batch.image == draw.image)
+			{
+				batchIndex = i - 1;
+				break;
+			}
+			if (batch.bounds.overlaps(drawBounds)) { break; }
+		}
+
+		if (batchIndex == mBatches.size())
+		{
+			mBatches.push_back({draw.layer, draw.image, drawBounds});
+		}
+		else
+		{
+			mBatches[batchIndex].bounds = combined(mBatches[batchIndex].bounds, drawBounds);
+		}
+		draw.batch = batchIndex;
+	}
+
+	std::stable_sort(mDraws.begin(), mDraws.end(), [](const Draw& a, const Draw& b) {
+		return a.batch < b.batch;
+	});
+}
+
+
+/**
+ * Gets the area a draw can cover. Rotated draws are bounded by the circle through
+ * their corners.
+ */
+Rectangle<float> RenderQueue::bounds(const Draw& draw)
+{
+	if (draw.type != DrawType::SubImageRotated)
+	{
+		return draw.destination;
+	}
+
+	const auto halfSize = draw.destination.size / 2;
+	const auto radius = std::sqrt(halfSize.lengthSquared());
+	const auto center = draw.destination.center();
+	return {center - Vector{radius, radius}, {radius * 2, radius * 2}};
+}
@@ -0,0 +1,98 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Math/Angle.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Image;
+	class Renderer;
+
+
+	/**
+	 * Collects draws and submits them to a Renderer sorted for batching.
+	 *
+	 * Each draw is given a layer and a depth. On flush(), draws are stably sorted by
+	 * layer, then depth, so draws with equal keys stay in submission order. Within a
+	 * layer, draws are then grouped by image: a draw moves back to join an earlier
+	 * draw of the same image, as long as it does not overlap anything drawn in
+	 * between. Overlapping draws keep their order, so translucent draws blend the
+	 * same as they would unsorted.
+	 *
+	 * Grouping is by image, which is the texture for images drawn from their own
+	 * texture. Images sharing a TextureAtlas page already batch with each other.
+	 *
+	 * Queued images are referred to, not copied, and must outlive the next flush().
+	 */
+	class RenderQueue
+	{
+	public:
+		static constexpr std::size_t MaxBatchLookback = 32;
+
+		void drawImage(const Image& image, Point<float> position, int layer = 0, float depth = 0, Color color = Color::Normal);
+		void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, int layer = 0, float depth = 0, Color color = Color::Normal);
+		void drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, int layer = 0, float depth = 0, Color color = Color::Normal);
+		void drawImageStretched(const Image& image, const Rectangle<float>& rect, int layer = 0, float depth = 0, Color color = Color::Normal);
+		void drawBoxFilled(const Rectangle<float>& rect, Color color, int layer = 0, float depth = 0);
+
+		std::size_t size() const;
+		bool empty() const;
+		void clear();
+
+		void flush(Renderer& renderer);
+		std::size_t batchCount() const;
+
+	private:
+		enum class DrawType : std::uint8_t
+		{
+			Image,
+			SubImage,
+			SubImageRotated,
+			ImageStretched,
+			BoxFilled,
+		};
+
+		struct Draw
+		{
+			DrawType type;
+			int layer;
+			float depth;
+			const Image* image;
+			Rectangle<float> destination;
+			Rectangle<float> source;
+			Angle angle;
+			Color color;
+			std::size_t batch;
+		};
+
+		struct Batch
+		{
+			int layer;
+			const Image* image;
+			Rectangle<float> bounds;
+		};
+
+		void sort();
+		static Rectangle<float> bounds(const Draw& draw);
+
+		std::vector<Draw> mDraws{};
+		std::vector<Batch> mBatches{};
+		std::size_t mBatchCount{0u};
+	};
+}
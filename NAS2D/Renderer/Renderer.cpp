@@ -9,14 +9,54 @@
 // ==================================================================================
 
 #include "Renderer.h"
+#include "ImageInstance.h"
+#include "TextMesh.h"
+#include "../Resource/Font.h"
 #include "../Math/Rectangle.h"
 
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 
 
 using namespace NAS2D;
 
 
+namespace
+{
+	/**
+	 * Flips negative sizes, so the rectangle spans from its smallest to largest corner.
+	 */
+	Rectangle<float> normalized(const Rectangle<float>& rect)
+	{
+		const auto start = rect.startPoint();
+		const auto end = rect.endPoint();
+		return Rectangle<float>::Create({std::min(start.x, end.x), std::min(start.y, end.y)}, {std::max(start.x, end.x), std::max(start.y, end.y)});
+	}
+
+
+	Rectangle<float> intersection(const Rectangle<float>& a, const Rectangle<float>& b)
+	{
+		const auto start = Point{std::max(a.position.x, b.position.x), std::max(a.position.y, b.position.y)};
+		const auto end = Point{std::min(a.endPoint().x, b.endPoint().x), std::min(a.endPoint().y, b.endPoint().y)};
+		return Rectangle<float>::Create(start, {std::max(start.x, end.x), std::max(start.y, end.y)});
+	}
+
+
+	/**
+	 * Checks if a normalized rectangle lies entirely outside an area. Touching edges
+	 * count as inside, so zero sized bounds on an edge are kept.
+	 */
+	bool isOutside(const Rectangle<float>& bounds, const Rectangle<float>& area)
+	{
+		const auto boundsEnd = bounds.endPoint();
+		const auto areaEnd = area.endPoint();
+		return boundsEnd.x < area.position.x || bounds.position.x > areaEnd.x || boundsEnd.y < area.position.y || bounds.position.y > areaEnd.y;
+	}
+}
+
+
 Renderer::Renderer() = default;
 
 
@@ -31,6 +71,104 @@ Renderer::~Renderer()
 }
 
 
+/**
+ * Draws many copies of parts of an image in one call.
+ *
+ * The default draws each instance with drawSubImageRotated. Renderers that can
+ * draw them all at once override this.
+ *
+ * \param offset	Added to the position of every instance.
+ */
+void Renderer::drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset)
+{
+	for (const auto& instance : instances)
+	{
+		drawSubImageRotated(image, instance.position + offset, instance.subImageRect, instance.angle, instance.color);
+	}
+}
+
+
+/**
+ * Draws many points in one call.
+ *
+ * \param colors	One color per point, or a single color used for every point.
+ */
+void Renderer::drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors)
+{
+	checkColorCount(positions.size(), colors);
+	for (std::size_t i = 0; i < positions.size(); ++i)
+	{
+		drawPoint(positions[i], colors[colors.size() == 1 ? 0 : i]);
+	}
+}
+
+
+/**
+ * Draws many lines in one call.
+ *
+ * \param endPoints	Start and end point of each line, in pairs.
+ * \param colors	One color per line, or a single color used for every line.
+ */
+void Renderer::drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth)
+{
+	if (endPoints.size() % 2 != 0)
+	{
+		throw std::runtime_error("drawLines requires an even number of end points: " + std::to_string(endPoints.size()));
+	}
+
+	const auto lineCount = endPoints.size() / 2;
+	checkColorCount(lineCount, colors);
+	for (std::size_t i = 0; i < lineCount; ++i)
+	{
+		drawLine(endPoints[i * 2], endPoints[i * 2 + 1], colors[colors.size() == 1 ? 0 : i], lineWidth);
+	}
+}
+
+
+/**
+ * Draws many box outlines in one call.
+ *
+ * \param colors	One color per box, or a single color used for every box.
+ */
+void Renderer::drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
+	for (std::size_t i = 0; i < rects.size(); ++i)
+	{
+		drawBox(rects[i], colors[colors.size() == 1 ? 0 : i]);
+	}
+}
+
+
+/**
+ * Draws many filled boxes in one call.
+ *
+ * \param colors	One color per box, or a single color used for every box.
+ */
+void Renderer::drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
+	for (std::size_t i = 0; i < rects.size(); ++i)
+	{
+		drawBoxFilled(rects[i], colors[colors.size() == 1 ? 0 : i]);
+	}
+}
+
+
+/**
+ * Draws text from a prebuilt TextMesh.
+ *
+ * The default draws the mesh's text with drawText. Renderers that can use the
+ * cached geometry override this.
+ */
+void Renderer::drawTextMesh(const TextMesh& textMesh, Point<float> position)
+{
+	if (textMesh.font() == nullptr) { return; }
+
+	drawText(*textMesh.font(), textMesh.text(), position, textMesh.color());
+}
+
+
 void Renderer::drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor)
 {
 	const auto shadowPosition = position + shadowOffset;
@@ -43,3 +181,254 @@ Point<int> Renderer::center() const
 {
 	return Point{0, 0} + mResolution / 2;
 }
+
+
+/**
+ * Restricts drawing to an area, replacing any pushed clip rects.
+ *
+ * Clip rects are in drawing coordinates, which match window pixels with the
+ * default projection.
+ */
+void Renderer::clipRect(const Rectangle<float>& rect)
+{
+	mClipStack.assign(1, normalized(rect));
+	onClipRect(mClipStack.back());
+}
+
+
+/**
+ * Removes all clipping, including pushed clip rects.
+ */
+void Renderer::clipRectClear()
+{
+	mClipStack.clear();
+	onClipRectClear();
+}
+
+
+/**
+ * Restricts drawing to the part of an area within the current clip rect.
+ *
+ * Undone by a matching popClipRect, which restores the previous clip rect.
+ */
+void Renderer::pushClipRect(const Rectangle<float>& rect)
+{
+	const auto clip = mClipStack.empty() ? normalized(rect) : intersection(mClipStack.back(), normalized(rect));
+	mClipStack.push_back(clip);
+	onClipRect(clip);
+}
+
+
+void Renderer::popClipRect()
+{
+	if (mClipStack.empty())
+	{
+		throw std::runtime_error("popClipRect called with no clip rect pushed");
+	}
+
+	mClipStack.pop_back();
+	applyClipStack();
+}
+
+
+/**
+ * Gets the number of clip rects currently in effect.
+ */
+std::size_t Renderer::clipDepth() const
+{
+	return mClipStack.size();
+}
+
+
+/**
+ * Gets the number of draws skipped for lying entirely outside the clip rect or view.
+ */
+std::size_t Renderer::culledDrawCount() const
+{
+	return mCulledDrawCount;
+}
+
+
+void Renderer::resetCulledDrawCount()
+{
+	mCulledDrawCount = 0;
+}
+
+
+/**
+ * Blocks until everything drawn so far has been submitted.
+ *
+ * Renderers that draw on the calling thread have nothing to wait for.
+ */
+void Renderer::finish()
+{
+}
+
+
+/**
+ * Makes the renderer's graphics context current on the calling thread.
+ */
+void Renderer::acquireContext()
+{
+}
+
+
+/**
+ * Detaches the renderer's graphics context from the calling thread, so another
+ * thread can acquire it.
+ */
+void Renderer::releaseContext()
+{
+}
+
+
+/**
+ * Checks the colors passed to a bulk draw call match the number of items drawn.
+ */
+void Renderer::checkColorCount(std::size_t itemCount, std::span<const Color> colors)
+{
+	if (itemCount > 0 && colors.size() != 1 && colors.size() != itemCount)
+	{
+		throw std::runtime_error("Bulk draw needs one color, or one per item: items = " + std::to_string(itemCount) + ", colors = " + std::to_string(colors.size()));
+	}
+}
+
+
+/**
+ * Gets an area covering a line of any width, for culling.
+ */
+Rectangle<float> Renderer::lineBounds(Point<float> startPosition, Point<float> endPosition, int lineWidth)
+{
+	const auto padding = static_cast<float>(std::max(lineWidth, 1));
+	return normalized(Rectangle<float>::Create(startPosition, endPosition)).inset(-padding);
+}
+
+
+/**
+ * Gets an area covering drawn text, for culling.
+ *
+ * Glyph cells can extend past the advance widths that make up the text size, so
+ * the area is padded by a cell on each side.
+ */
+Rectangle<float> Renderer::textBounds(const Font& font, Vector<int> textSize, Point<float> position)
+{
+	return Rectangle{position, textSize.to<float>()}.inset(font.glyphCellSize().to<float>() * -1.0f);
+}
+
+
+/**
+ * Applies the clip rect on top of the clip stack, or removes clipping if it is empty.
+ */
+void Renderer::applyClipStack()
+{
+	if (mClipStack.empty())
+	{
+		onClipRectClear();
+	}
+	else
+	{
+		onClipRect(mClipStack.back());
+	}
+}
+
+
+/**
+ * Draws into an image until the matching popRenderTarget.
+ *
+ * Unlike setRenderTarget, pushes nest: popping returns drawing to the previous
+ * render target, with its clip rects, or to the window if there was none.
+ */
+void Renderer::pushRenderTarget(const Image& image)
+{
+	// The window's clip stack is kept by renderTargetClip, so only images need theirs kept here
+	auto clipStack = mRenderTargetStack.empty() ? std::vector<Rectangle<float>>{} : mClipStack;
+	mRenderTargetStack.emplace_back(&image, std::move(clipStack));
+	setRenderTarget(image);
+}
+
+
+void Renderer::popRenderTarget()
+{
+	if (mRenderTargetStack.empty())
+	{
+		throw std::runtime_error("popRenderTarget called with no render target pushed");
+	}
+
+	auto clipStack = std::move(mRenderTargetStack.back().second);
+	mRenderTargetStack.pop_back();
+	if (mRenderTargetStack.empty())
+	{
+		resetRenderTarget();
+		return;
+	}
+
+	setRenderTarget(*mRenderTargetStack.back().first);
+	mClipStack = std::move(clipStack);
+	applyClipStack();
+}
+
+
+/**
+ * Switches clip stacks when drawing moves to or from a render target.
+ *
+ * Render targets start out unclipped. The window's clip stack is put aside while
+ * drawing into them, and restored when drawing returns to the window, so clip
+ * rects pushed around drawing into a target stay balanced. Renderers call this
+ * when changing targets, then applyClipStack once their viewport is set up.
+ */
+void Renderer::renderTargetClip(bool renderingToImage)
+{
+	if (renderingToImage)
+	{
+		if (!mScreenClipStack)
+		{
+			mScreenClipStack = std::move(mClipStack);
+		}
+		mClipStack.clear();
+	}
+	else if (mScreenClipStack)
+	{
+		mClipStack = std::move(*mScreenClipStack);
+		mScreenClipStack.reset();
+	}
+}
+
+
+/**
+ * Sets the visible area, in drawing coordinates, that draws are culled against.
+ *
+ * Renderers that cull call this whenever their projection changes.
+ */
+void Renderer::cullArea(const Rectangle<float>& orthoBounds)
+{
+	mCullArea = normalized(orthoBounds);
+}
+
+
+/**
+ * Checks if a draw can be skipped because its bounds lie entirely outside the
+ * current clip rect or the visible area, and counts it if so.
+ *
+ * \param bounds	Area covered by the draw, in drawing coordinates.
+ */
+bool Renderer::isCulled(const Rectangle<float>& bounds)
+{
+	const auto normalizedBounds = normalized(bounds);
+	if ((mCullArea && isOutside(normalizedBounds, *mCullArea)) || (!mClipStack.empty() && isOutside(normalizedBounds, mClipStack.back())))
+	{
+		++mCulledDrawCount;
+		return true;
+	}
+	return false;
+}
+
+
+/**
+ * Checks if a draw within a radius of a point can be skipped. Suits circles and
+ * rotated quads, which stay within their half diagonal of their center.
+ */
+bool Renderer::isCulled(Point<float> center, float radius)
+{
+	const auto absRadius = std::abs(radius);
+	return isCulled({center - Vector{absRadius, absRadius}, {absRadius * 2, absRadius * 2}});
+}
@@ -12,9 +12,15 @@
 
 #include "Color.h"
 #include "Window.h"
+#include "../Math/Rectangle.h"
 
+#include <cstddef>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace NAS2D
@@ -22,15 +28,10 @@ namespace NAS2D
 
 	class Font;
 	class Image;
+	class TextMesh;
+	struct ImageInstance;
 	class Angle;
 
-	template <typename BaseType>
-	struct Point;
-	template <typename BaseType>
-	struct Vector;
-	template <typename BaseType>
-	struct Rectangle;
-
 
 	class Renderer : public Window
 	{
@@ -45,6 +46,7 @@ namespace NAS2D
 		virtual void drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color = Color::Normal) = 0;
 		virtual void drawImageRepeated(const Image& image, const Rectangle<float>& rect) = 0;
 		virtual void drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source) = 0;
+		virtual void drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset = Vector{0.0f, 0.0f});
 
 		virtual void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) = 0;
 
@@ -53,26 +55,68 @@ namespace NAS2D
 		virtual void drawBox(const Rectangle<float>& rect, Color color = Color::White) = 0;
 		virtual void drawBoxFilled(const Rectangle<float>& rect, Color color = Color::White) = 0;
 		virtual void drawCircle(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) = 0;
+		virtual void drawCircleFilled(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) = 0;
+
+		virtual void drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors);
+		virtual void drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth = 1);
+		virtual void drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors);
+		virtual void drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors);
 
 		virtual void drawGradient(const Rectangle<float>& rect, Color colorUpperLeft, Color colorLowerLeft, Color colorLowerRight, Color colorUpperRight) = 0;
 
 		virtual void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) = 0;
+		virtual void drawTextMesh(const TextMesh& textMesh, Point<float> position);
 		void drawTextShadow(const Font& font, std::string_view text, Point<float> position, Vector<float> shadowOffset, Color textColor, Color shadowColor);
 
 		virtual void clearScreen(Color color = Color::Black) = 0;
 
 		Point<int> center() const;
 
-		virtual void clipRect(const Rectangle<float>& rect) = 0;
-		virtual void clipRectClear() = 0;
+		void clipRect(const Rectangle<float>& rect);
+		void clipRectClear();
+		void pushClipRect(const Rectangle<float>& rect);
+		void popClipRect();
+		std::size_t clipDepth() const;
+
+		std::size_t culledDrawCount() const;
+		void resetCulledDrawCount();
 
 		virtual void update() = 0;
+		virtual void finish();
+
+		virtual void acquireContext();
+		virtual void releaseContext();
 
 		virtual void setViewport(const Rectangle<int>& viewport) = 0;
 		virtual void setOrthoProjection(const Rectangle<float>& orthoBounds) = 0;
 
+		virtual void setRenderTarget(const Image& image) = 0;
+		virtual void resetRenderTarget() = 0;
+		void pushRenderTarget(const Image& image);
+		void popRenderTarget();
+
 	protected:
 		Renderer(const std::string& appTitle);
+
+		static void checkColorCount(std::size_t itemCount, std::span<const Color> colors);
+		static Rectangle<float> lineBounds(Point<float> startPosition, Point<float> endPosition, int lineWidth);
+		static Rectangle<float> textBounds(const Font& font, Vector<int> textSize, Point<float> position);
+
+		virtual void onClipRect(const Rectangle<float>& rect) = 0;
+		virtual void onClipRectClear() = 0;
+		void applyClipStack();
+		void renderTargetClip(bool renderingToImage);
+
+		void cullArea(const Rectangle<float>& orthoBounds);
+		bool isCulled(const Rectangle<float>& bounds);
+		bool isCulled(Point<float> center, float radius);
+
+	private:
+		std::vector<Rectangle<float>> mClipStack{};
+		std::optional<std::vector<Rectangle<float>>> mScreenClipStack{};
+		std::vector<std::pair<const Image*, std::vector<Rectangle<float>>>> mRenderTargetStack{};
+		std::optional<Rectangle<float>> mCullArea{};
+		std::size_t mCulledDrawCount{0u};
 	};
 
 }
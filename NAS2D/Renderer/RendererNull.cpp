@@ -47,6 +47,11 @@ void RendererNull::drawSubImageRepeated(const Image&, const Rectangle<float>&, c
 }
 
 
+void RendererNull::drawImageInstances(const Image&, std::span<const ImageInstance>, Vector<float>)
+{
+}
+
+
 void RendererNull::drawImageToImage(const Image&, const Image&, Point<float>)
 {
 }
@@ -77,6 +82,31 @@ void RendererNull::drawCircle(Point<float>, float, Color, int, Vector<float>)
 }
 
 
+void RendererNull::drawCircleFilled(Point<float>, float, Color, int, Vector<float>)
+{
+}
+
+
+void RendererNull::drawPoints(std::span<const Point<float>>, std::span<const Color>)
+{
+}
+
+
+void RendererNull::drawLines(std::span<const Point<float>>, std::span<const Color>, int)
+{
+}
+
+
+void RendererNull::drawBoxes(std::span<const Rectangle<float>>, std::span<const Color>)
+{
+}
+
+
+void RendererNull::drawBoxesFilled(std::span<const Rectangle<float>>, std::span<const Color>)
+{
+}
+
+
 void RendererNull::drawGradient(const Rectangle<float>&, Color, Color, Color, Color)
 {
 }
@@ -92,12 +122,12 @@ void RendererNull::clearScreen(Color)
 }
 
 
-void RendererNull::clipRect(const Rectangle<float>&)
+void RendererNull::onClipRect(const Rectangle<float>&)
 {
 }
 
 
-void RendererNull::clipRectClear()
+void RendererNull::onClipRectClear()
 {
 }
 
@@ -115,3 +145,13 @@ void RendererNull::setViewport(const Rectangle<int>&)
 void RendererNull::setOrthoProjection(const Rectangle<float>&)
 {
 }
+
+
+void RendererNull::setRenderTarget(const Image&)
+{
+}
+
+
+void RendererNull::resetRenderTarget()
+{
+}
@@ -35,6 +35,8 @@ namespace NAS2D
 		void drawImageRepeated(const Image&, const Rectangle<float>&) override;
 		void drawSubImageRepeated(const Image&, const Rectangle<float>&, const Rectangle<float>&) override;
 
+		void drawImageInstances(const Image&, std::span<const ImageInstance>, Vector<float> = Vector{0.0f, 0.0f}) override;
+
 		void drawImageToImage(const Image&, const Image&, Point<float>) override;
 
 		void drawPoint(Point<float>, Color = Color::White) override;
@@ -42,6 +44,12 @@ namespace NAS2D
 		void drawBox(const Rectangle<float>&, Color = Color::White) override;
 		void drawBoxFilled(const Rectangle<float>&, Color = Color::White) override;
 		void drawCircle(Point<float>, float, Color, int = 10, Vector<float> = Vector{1.0f, 1.0f}) override;
+		void drawCircleFilled(Point<float>, float, Color, int = 10, Vector<float> = Vector{1.0f, 1.0f}) override;
+
+		void drawPoints(std::span<const Point<float>>, std::span<const Color>) override;
+		void drawLines(std::span<const Point<float>>, std::span<const Color>, int = 1) override;
+		void drawBoxes(std::span<const Rectangle<float>>, std::span<const Color>) override;
+		void drawBoxesFilled(std::span<const Rectangle<float>>, std::span<const Color>) override;
 
 		void drawGradient(const Rectangle<float>&, Color, Color, Color, Color) override;
 
@@ -49,13 +57,17 @@ namespace NAS2D
 
 		void clearScreen(Color = Color::Black) override;
 
-		void clipRect(const Rectangle<float>&) override;
-		void clipRectClear() override;
-
 		void update() override;
 
 		void setViewport(const Rectangle<int>&) override;
 		void setOrthoProjection(const Rectangle<float>&) override;
+
+		void setRenderTarget(const Image&) override;
+		void resetRenderTarget() override;
+
+	protected:
+		void onClipRect(const Rectangle<float>&) override;
+		void onClipRectClear() override;
 	};
 
 }
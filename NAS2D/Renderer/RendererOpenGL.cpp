@@ -9,10 +9,14 @@
 // ==================================================================================
 
 #include "RendererOpenGL.h"
+#include "GLStateCache.h"
+#include "ImageInstance.h"
+#include "TextMesh.h"
 
 #include "../Math/VectorSizeRange.h"
 #include "../Resource/Image.h"
 #include "../Resource/Font.h"
+#include "../Resource/TextureUploadQueue.h"
 #include "../Math/Angle.h"
 #include "../Math/Trig.h"
 #include "../Configuration.h"
@@ -32,56 +36,221 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <array>
 #include <vector>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 
 using namespace NAS2D;
 
 
+extern unsigned int generateTexture(const void* buffer, int bytesPerPixel, int width, int height);
+
+
 namespace
 {
-	constexpr std::array<GLfloat, 12> rectToQuad(Rectangle<GLfloat> rect)
+	constexpr Rectangle<float> DefaultTextureRect{{0, 0}, {1, 1}};
+
+	// Initial size of the streaming vertex buffer, enough for about 35,000 quads per frame
+	constexpr std::size_t VertexBufferCapacity = 4 * 1024 * 1024;
+
+	constexpr GLuint PositionAttribute = 0;
+	constexpr GLuint TextureCoordAttribute = 1;
+	constexpr GLuint ColorAttribute = 2;
+
+	constexpr GLuint InstanceDestinationAttribute = 0;
+	constexpr GLuint InstanceTextureRectAttribute = 1;
+	constexpr GLuint InstanceRotationAttribute = 2;
+	constexpr GLuint InstanceColorAttribute = 3;
+
+	constexpr auto VertexShaderSource = R"(
+		#version 330 core
+		layout(location = 0) in vec2 position;
+		layout(location = 1) in vec2 textureCoord;
+		layout(location = 2) in vec4 color;
+		uniform mat4 projection;
+		out vec2 fragmentTextureCoord;
+		out vec4 fragmentColor;
+		void main()
+		{
+			gl_Position = projection * vec4(position, 0.0, 1.0);
+			fragmentTextureCoord = textureCoord;
+			fragmentColor = color;
+		}
+	)";
+
+	// Instances are drawn as a four vertex triangle strip generated from gl_VertexID
+	constexpr auto InstanceVertexShaderSource = R"(
+		#version 330 core
+		layout(location = 0) in vec4 destination;
+		layout(location = 1) in vec4 textureRect;
+		layout(location = 2) in vec2 rotation;
+		layout(location = 3) in vec4 color;
+		uniform mat4 projection;
+		out vec2 fragmentTextureCoord;
+		out vec4 fragmentColor;
+		void main()
+		{
+			vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+			vec2 offset = (corner - 0.5) * destination.zw;
+			vec2 rotated = vec2(offset.x * rotation.x - offset.y * rotation.y, offset.x * rotation.y + offset.y * rotation.x);
+			gl_Position = projection * vec4(destination.xy + destination.zw * 0.5 + rotated, 0.0, 1.0);
+			fragmentTextureCoord = textureRect.xy + corner * textureRect.zw;
+			fragmentColor = color;
+		}
+	)";
+
+	constexpr auto FragmentShaderSource = R"(
+		#version 330 core
+		in vec2 fragmentTextureCoord;
+		in vec4 fragmentColor;
+		uniform sampler2D textureSampler;
+		out vec4 outputColor;
+		void main()
+		{
+			outputColor = texture(textureSampler, fragmentTextureCoord) * fragmentColor;
+		}
+	)";
+
+
+	struct LineGeometry
 	{
-		const auto p1 = rect.position;
-		const auto p2 = rect.endPoint();
+		std::array<Vertex, 8> body;
+		std::array<Vertex, 10> caps;
+		bool hasCaps;
+	};
 
-		return {
-			p1.x,
-			p1.y,
 
-			p1.x,
-			p2.y,
+	LineGeometry line(Point<float> p1, Point<float> p2, float lineWidth, Color color);
 
-			p2.x,
-			p2.y,
 
+	/**
+	 * Builds the line segments outlining a rectangle.
+	 */
+	constexpr std::array<Vertex, 8> boxOutline(const Rectangle<float>& rect, Color color)
+	{
+		const auto p1 = rect.position + Vector{0.5f, 0.5f}; // OpenGL centers pixels between integer values
+		const auto p2 = rect.endPoint(); // No adjustment here so as to exclude the bottom right sides
+		const auto corner1 = Vertex{p1, {}, color};
+		const auto corner2 = Vertex{{p2.x, p1.y}, {}, color};
+		const auto corner3 = Vertex{p2, {}, color};
+		const auto corner4 = Vertex{{p1.x, p2.y}, {}, color};
+		return {{corner1, corner2, corner2, corner3, corner3, corner4, corner4, corner1}};
+	}
+
+
+	/**
+	 * Builds a quad centered on \c center and rotated about it.
+	 *
+	 * Rotation is done on the CPU so rotated sprites can share batches with
+	 * everything else.
+	 */
+	std::array<Vertex, 6> rotatedQuad(Point<float> center, Vector<float> halfSize, Angle angle, const Rectangle<float>& textureRect, Color color)
+	{
+		const auto radians = angle.radians();
+		const auto sine = std::sin(radians);
+		const auto cosine = std::cos(radians);
+
+		auto quad = rectToQuad({{-halfSize.x, -halfSize.y}, halfSize * 2}, textureRect, color);
+		for (auto& vertex : quad)
+		{
+			const auto offset = vertex.position;
+			vertex.position = center + Vector{offset.x * cosine - offset.y * sine, offset.x * sine + offset.y * cosine};
+		}
+		return quad;
+	}
 
-			p2.x,
-			p2.y,
 
-			p2.x,
-			p1.y,
+	/**
+	 * Maps a normalized rectangle within an image onto the image's area of its texture.
+	 */
+	constexpr Rectangle<float> subTextureRect(const Rectangle<float>& textureRect, const Rectangle<float>& unitRect)
+	{
+		const auto scaled = unitRect.skewBy(textureRect.size);
+		return {textureRect.position + (scaled.position - Point<float>{0.0f, 0.0f}), scaled.size};
+	}
+
 
-			p1.x,
-			p1.y,
+	template <std::size_t VertexCount>
+	constexpr std::array<Vertex, (VertexCount - 2) * 3> triangleStripToTriangles(const std::array<Vertex, VertexCount>& strip)
+	{
+		std::array<Vertex, (VertexCount - 2) * 3> triangles{};
+		for (std::size_t i = 0; i + 2 < VertexCount; ++i)
+		{
+			triangles[i * 3] = strip[i];
+			triangles[i * 3 + 1] = strip[i + 1];
+			triangles[i * 3 + 2] = strip[i + 2];
+		}
+		return triangles;
+	}
+
+
+	/**
+	 * Column major orthographic projection matching glOrtho with the y axis pointing down.
+	 */
+	std::array<GLfloat, 16> orthoMatrix(const Rectangle<float>& bounds)
+	{
+		const auto left = bounds.position.x;
+		const auto right = bounds.endPoint().x;
+		const auto top = bounds.position.y;
+		const auto bottom = bounds.endPoint().y;
+
+		return {
+			2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+			0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+			0.0f, 0.0f, -1.0f, 0.0f,
+			-(right + left) / (right - left), -(top + bottom) / (top - bottom), 0.0f, 1.0f,
 		};
 	}
 
 
-	constexpr auto DefaultTextureCoords = rectToQuad({{0, 0}, {1, 1}});
+	GLuint compileShader(GLenum type, const char* source)
+	{
+		const auto shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
 
+		GLint status = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			std::string log(1024, '\0');
+			glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, log.data());
+			glDeleteShader(shader);
+			throw std::runtime_error("Shader compilation failed: " + std::string{log.c_str()});
+		}
+		return shader;
+	}
 
-	void drawTexturedQuad(GLuint textureId, const std::array<GLfloat, 12>& verticies, const std::array<GLfloat, 12>& textureCoords = DefaultTextureCoords);
-	void line(Point<float> p1, Point<float> p2, float lineWidth, Color color);
 
-	void setColor(Color color)
+	GLuint linkProgram(const char* vertexSource, const char* fragmentSource)
 	{
-		glColor4ub(color.red, color.green, color.blue, color.alpha);
+		const auto vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+		const auto fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+		const auto program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			std::string log(1024, '\0');
+			glGetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, log.data());
+			glDeleteProgram(program);
+			throw std::runtime_error("Shader program link failed: " + std::string{log.c_str()});
+		}
+		return program;
 	}
 
+
 	std::string glString(GLenum name)
 	{
 		const auto apiResult = glGetString(name);
@@ -104,6 +273,7 @@ RendererOpenGL::Options RendererOpenGL::ReadConfigurationOptions(const Configura
 		{graphics.get<int>("screenwidth"), graphics.get<int>("screenheight")},
 		graphics.get<bool>("fullscreen"),
 		graphics.get<bool>("vsync"),
+		graphics.get<bool>("coreprofile", false),
 	};
 }
 
@@ -116,6 +286,7 @@ void RendererOpenGL::WriteConfigurationOptions(const Options& options)
 	graphics.set("screenheight", options.resolution.y);
 	graphics.set("fullscreen", options.fullscreen);
 	graphics.set("vsync", options.vsync);
+	graphics.set("coreprofile", options.coreProfile);
 }
 
 
@@ -126,7 +297,8 @@ RendererOpenGL::RendererOpenGL(const std::string& title) :
 
 
 RendererOpenGL::RendererOpenGL(const std::string& title, const Options& options) :
-	Renderer(title)
+	Renderer(title),
+	mCoreProfile{options.coreProfile}
 {
 	initVideo(options.resolution, options.fullscreen, options.vsync);
 }
@@ -136,6 +308,20 @@ RendererOpenGL::~RendererOpenGL()
 {
 	Utility<EventHandler>::get().windowResized().disconnect({this, &RendererOpenGL::onResize});
 
+	mVertexBuffer.reset();
+	deleteGpuTimers();
+	if (mRenderTargetFramebuffer != 0)
+	{
+		Utility<GLStateCache>::get().deleteFramebuffer(mRenderTargetFramebuffer);
+	}
+	if (mCoreProfile)
+	{
+		Utility<GLStateCache>::get().deleteTexture(mWhiteTexture);
+		glDeleteVertexArrays(1, &mInstanceVertexArray);
+		glDeleteProgram(mInstanceProgram);
+		glDeleteVertexArrays(1, &mVertexArray);
+		glDeleteProgram(mShaderProgram);
+	}
 	SDL_GL_DeleteContext(sdlOglContext);
 	SDL_DestroyWindow(window);
 	window = nullptr;
@@ -167,121 +353,174 @@ std::string RendererOpenGL::getShaderVersion()
 }
 
 
-void RendererOpenGL::drawImage(const Image& image, Point<float> position, float scale, Color color)
+/**
+ * Statistics for the most recently completed frame.
+ *
+ * GPU timings are read a frame later than they were recorded, so that reading
+ * them never waits on the GPU. They are those of the frame before the one the
+ * counters are for, and are left empty if the GPU has not finished it yet.
+ */
+const RendererOpenGL::FrameStats& RendererOpenGL::frameStats() const
 {
-	setColor(color);
-
-	const auto imageSize = image.size().to<float>() * scale;
-	const auto vertexArray = rectToQuad({position, imageSize});
-	drawTexturedQuad(image.textureId(), vertexArray);
+	return mFrameStats;
 }
 
 
-void RendererOpenGL::drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color)
+bool RendererOpenGL::gpuTimingSupported() const
 {
-	setColor(color);
+	return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
 
-	const auto& subImageSize = subImageRect.size;
-	const auto vertexArray = rectToQuad({raster, subImageSize});
-	const auto imageSize = image.size().to<float>();
-	const auto textureCoordArray = rectToQuad(subImageRect.skewInverseBy(imageSize));
 
-	drawTexturedQuad(image.textureId(), vertexArray, textureCoordArray);
+bool RendererOpenGL::gpuTimingEnabled() const
+{
+	return mGpuTimingEnabled;
 }
 
 
-void RendererOpenGL::drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color)
+/**
+ * Turns GPU timer queries on or off. While off, the timer calls do nothing.
+ */
+void RendererOpenGL::gpuTimingEnabled(bool enabled)
 {
-	glPushMatrix();
+	if (enabled && !gpuTimingSupported())
+	{
+		throw std::runtime_error("GPU timing requires OpenGL 3.3 or ARB_timer_query: " + getDriverVersion());
+	}
 
-	const auto translate = subImageRect.size.to<float>() / 2;
-	const auto center = raster + translate;
+	// Drop this frame's queries, since open timers will never be ended
+	mGpuTimingEnabled = enabled;
+	mOpenGpuTimers.clear();
+	mGpuTimerFrames[mGpuTimerFrameIndex].usedCount = 0;
+}
 
-	glTranslatef(center.x, center.y, 0.0f);
-	glRotatef(angle.degrees(), 0.0f, 0.0f, 1.0f);
 
-	setColor(color);
+/**
+ * Starts timing the GPU work for a named part of the frame.
+ *
+ * Timers may be nested, and are ended in reverse order with endGpuTimer.
+ */
+void RendererOpenGL::beginGpuTimer(std::string_view name)
+{
+	if (!mGpuTimingEnabled) { return; }
 
-	const auto vertexArray = rectToQuad({{-translate.x, -translate.y}, translate * 2});
-	const auto imageSize = image.size().to<float>();
-	const auto textureCoordArray = rectToQuad(subImageRect.skewInverseBy(imageSize));
+	flush();
 
-	drawTexturedQuad(image.textureId(), vertexArray, textureCoordArray);
+	auto& timerFrame = mGpuTimerFrames[mGpuTimerFrameIndex];
+	if (timerFrame.usedCount == timerFrame.queries.size())
+	{
+		auto& query = timerFrame.queries.emplace_back();
+		glGenQueries(1, &query.beginQuery);
+		glGenQueries(1, &query.endQuery);
+	}
 
-	glPopMatrix();
+	auto& query = timerFrame.queries[timerFrame.usedCount];
+	query.name = name;
+	glQueryCounter(query.beginQuery, GL_TIMESTAMP);
+	mOpenGpuTimers.push_back(timerFrame.usedCount);
+	++timerFrame.usedCount;
 }
 
 
-void RendererOpenGL::drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color, float scale)
+void RendererOpenGL::endGpuTimer()
 {
-	glPushMatrix();
+	if (!mGpuTimingEnabled || mOpenGpuTimers.empty()) { return; }
+
+	flush();
+
+	const auto& query = mGpuTimerFrames[mGpuTimerFrameIndex].queries[mOpenGpuTimers.back()];
+	glQueryCounter(query.endQuery, GL_TIMESTAMP);
+	mOpenGpuTimers.pop_back();
+}
 
-	const auto halfSize = image.size().to<float>() / 2;
-	const auto scaledHalfSize = halfSize * scale;
-	const auto center = position + halfSize;
 
-	glTranslatef(center.x, center.y, 0.0f);
+void RendererOpenGL::drawImage(const Image& image, Point<float> position, float scale, Color color)
+{
+	const auto imageSize = image.size().to<float>() * scale;
+	if (isCulled({position, imageSize})) { return; }
 
-	glRotatef(angle.degrees(), 0.0f, 0.0f, 1.0f);
+	const auto textureArea = image.textureArea();
+	addQuad(textureArea.textureId, {position, imageSize}, textureArea.textureRect, color);
+}
 
-	setColor(color);
-	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
-	const auto vertexArray = rectToQuad({{-scaledHalfSize.x, -scaledHalfSize.y}, scaledHalfSize * 2});
+void RendererOpenGL::drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color)
+{
+	if (isCulled({raster, subImageRect.size})) { return; }
 
-	drawTexturedQuad(image.textureId(), vertexArray);
-	glPopMatrix();
+	const auto imageSize = image.size().to<float>();
+	const auto textureArea = image.textureArea();
+	addQuad(textureArea.textureId, {raster, subImageRect.size}, subTextureRect(textureArea.textureRect, subImageRect.skewInverseBy(imageSize)), color);
 }
 
 
-void RendererOpenGL::drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color)
+void RendererOpenGL::drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color)
 {
-	setColor(color);
-	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	const auto translate = subImageRect.size.to<float>() / 2;
+	const auto center = raster + translate;
+	if (isCulled(center, std::sqrt(translate.lengthSquared()))) { return; }
 
-	const auto vertexArray = rectToQuad(rect);
-	drawTexturedQuad(image.textureId(), vertexArray);
+	const auto imageSize = image.size().to<float>();
+	const auto textureArea = image.textureArea();
+	addVertices(GL_TRIANGLES, textureArea.textureId, rotatedQuad(center, translate, angle, subTextureRect(textureArea.textureRect, subImageRect.skewInverseBy(imageSize)), color));
 }
 
 
-void RendererOpenGL::drawImageRepeated(const Image& image, const Rectangle<float>& rect)
+void RendererOpenGL::drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color, float scale)
 {
-	setColor(Color::White);
+	const auto halfSize = image.size().to<float>() / 2;
+	const auto scaledHalfSize = halfSize * scale;
+	const auto center = position + halfSize;
+	if (isCulled(center, std::sqrt(scaledHalfSize.lengthSquared()))) { return; }
+
+	const auto textureArea = image.textureArea();
+	addVertices(GL_TRIANGLES, textureArea.textureId, rotatedQuad(center, scaledHalfSize, angle, textureArea.textureRect, color));
+}
 
-	glBindTexture(GL_TEXTURE_2D, image.textureId());
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+void RendererOpenGL::drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color)
+{
+	if (isCulled(rect)) { return; }
 
-	const auto vertexArray = rectToQuad(rect);
-	const auto imageSize = image.size().to<float>();
-	const auto textureCoordArray = rectToQuad(Rectangle{{0.0f, 0.0f}, rect.size.skewInverseBy(imageSize)});
+	const auto textureArea = image.textureArea();
+	addQuad(textureArea.textureId, rect, textureArea.textureRect, color);
+}
 
-	glVertexPointer(2, GL_FLOAT, 0, vertexArray.data());
 
-	glTexCoordPointer(2, GL_FLOAT, 0, textureCoordArray.data());
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
+void RendererOpenGL::drawImageRepeated(const Image& image, const Rectangle<float>& rect)
+{
+	if (isCulled(rect)) { return; }
 
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	const auto imageSize = image.size().to<float>();
+	const auto textureRect = Rectangle<float>{{0.0f, 0.0f}, rect.size.skewInverseBy(imageSize)};
+	addVertices(GL_TRIANGLES, image.textureId(), rectToQuad(rect, textureRect, Color::White), TextureWrap::Repeat);
 }
 
 
 /**
  * Draws part of a larger texture repeated.
  *
- * This is a brute force method of doing this. Unfortunately OpenGL doesn't do texture
- * wrapping for only part of a texture, it only does it if geometry area is larger than
- * an entire texture.
+ * OpenGL only wraps texture coordinates at the edges of a whole texture, so the
+ * source area is drawn from a cached copy in a texture of its own, as a single
+ * quad with GL_REPEAT.
  *
- * There are two possible ways to get much better performance out of this: Use a fragment
- * shader (probably the simplest) or have the Renderer save the texture portion as a new
- * texture and reference it that way (bit of overhead to do a texture lookup and would
- * get unmanageable very quickly.
+ * Source areas that can't be copied, such as fractional areas or areas of images
+ * that have been rendered into, fall back to clipping and drawing one quad per tile.
  */
 void RendererOpenGL::drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source)
 {
-	clipRect(destination);
+	if (isCulled(destination)) { return; }
+
+	const auto sourceInt = source.to<int>();
+	const auto repeatTextureId = (sourceInt.to<float>() == source) ? image.repeatTextureId(sourceInt) : 0u;
+	if (repeatTextureId != 0)
+	{
+		const auto textureRect = Rectangle<float>{{0.0f, 0.0f}, destination.size.skewInverseBy(source.size)};
+		addVertices(GL_TRIANGLES, repeatTextureId, rectToQuad(destination, textureRect, Color::White), TextureWrap::Repeat);
+		return;
+	}
+
+	pushClipRect(destination);
 
 	const auto tileCountSize = destination.size.skewInverseBy(source.size).to<int>() + Vector{1, 1};
 	for (const auto tileOffset : VectorSizeRange(tileCountSize))
@@ -289,257 +528,433 @@ void RendererOpenGL::drawSubImageRepeated(const Image& image, const Rectangle<fl
 		drawSubImage(image, destination.position + tileOffset.to<float>().skewBy(source.size), source);
 	}
 
-	clipRectClear();
+	popClipRect();
 }
 
 
-void RendererOpenGL::drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint)
+/**
+ * Draws many copies of parts of an image.
+ *
+ * With the shader pipeline the instances are drawn with a single instanced draw
+ * call, so only their attributes are sent to the GPU. Otherwise the quads are
+ * built on the CPU and queued as one batch.
+ *
+ * \param offset	Added to the position of every instance.
+ */
+void RendererOpenGL::drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset)
 {
-	const auto dstPointInt = dstPoint.to<int>();
-	const auto sourceSize = source.size();
+	if (instances.empty()) { return; }
 
-	const auto sourceBoundsInDestination = Rectangle{dstPointInt, sourceSize};
-	const auto destinationBounds = Rectangle{Point{0, 0}, destination.size()};
+	const auto imageSize = image.size().to<float>();
+	const auto textureArea = image.textureArea();
 
-	if (!sourceBoundsInDestination.overlaps(destinationBounds))
+	if (!mCoreProfile)
 	{
+		mScratchVertices.clear();
+		for (const auto& instance : instances)
+		{
+			const auto halfSize = instance.subImageRect.size / 2;
+			const auto textureRect = subTextureRect(textureArea.textureRect, instance.subImageRect.skewInverseBy(imageSize));
+			const auto quad = rotatedQuad(instance.position + offset + halfSize, halfSize, instance.angle, textureRect, instance.color);
+			mScratchVertices.insert(mScratchVertices.end(), quad.begin(), quad.end());
+		}
+		addVertices(GL_TRIANGLES, textureArea.textureId, mScratchVertices);
 		return;
 	}
 
-	const auto availableSize = destinationBounds.endPoint() - dstPointInt;
-	const auto clipSize = Vector{std::min(sourceSize.x, availableSize.x), std::min(sourceSize.y, availableSize.y)}.to<float>();
+	flush();
+
+	mInstanceData.clear();
+	for (const auto& instance : instances)
+	{
+		const auto radians = instance.angle.radians();
+		mInstanceData.push_back({
+			{instance.position + offset, instance.subImageRect.size},
+			subTextureRect(textureArea.textureRect, instance.subImageRect.skewInverseBy(imageSize)),
+			{std::cos(radians), std::sin(radians)},
+			instance.color,
+		});
+	}
 
-	setColor(Color::White);
+	auto& glState = Utility<GLStateCache>::get();
+	glState.textureWrap(textureArea.textureId, TextureWrap::ClampToEdge);
+	glState.bindTexture(textureArea.textureId);
 
-	glBindTexture(GL_TEXTURE_2D, destination.textureId());
+	const auto bufferOffset = mVertexBuffer->write(std::as_bytes(std::span{mInstanceData}));
+	const auto* base = reinterpret_cast<const std::byte*>(bufferOffset);
 
-	GLuint fbo = destination.frameBufferObjectId();
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, destination.textureId(), 0);
-	// OpenGL expects UV texture coordinates to start at the lower left.
-	const auto vertexArray = rectToQuad({{dstPoint.x, static_cast<float>(destination.size().y) - dstPoint.y}, {clipSize.x, -clipSize.y}});
+	glUseProgram(mInstanceProgram);
+	glBindVertexArray(mInstanceVertexArray);
+	glVertexAttribPointer(InstanceDestinationAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), base + offsetof(InstanceData, destination));
+	glVertexAttribPointer(InstanceTextureRectAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), base + offsetof(InstanceData, textureRect));
+	glVertexAttribPointer(InstanceRotationAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(InstanceData), base + offsetof(InstanceData, rotation));
+	glVertexAttribPointer(InstanceColorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(InstanceData), base + offsetof(InstanceData, color));
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(mInstanceData.size()));
+	countDraw(mInstanceData.size() * 4, mInstanceData.size() * sizeof(InstanceData));
 
-	drawTexturedQuad(source.textureId(), vertexArray);
-	glBindTexture(GL_TEXTURE_2D, destination.textureId());
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glBindVertexArray(mVertexArray);
+	glUseProgram(mShaderProgram);
 }
 
 
-void RendererOpenGL::drawPoint(Point<float> position, Color color)
+/**
+ * Draws an image into another image.
+ *
+ * Drawing goes back to the current render target afterwards, with its viewport,
+ * projection and clipping reset.
+ */
+void RendererOpenGL::drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint)
 {
-	glDisable(GL_TEXTURE_2D);
+	const auto* previousTarget = mRenderTarget;
 
-	setColor(color);
+	setRenderTarget(destination);
+	drawImage(source, dstPoint);
 
-	GLfloat pointVertexArray[2] = {position.x + 0.5f, position.y + 0.5f};
+	if (previousTarget)
+	{
+		setRenderTarget(*previousTarget);
+	}
+	else
+	{
+		resetRenderTarget();
+	}
+}
 
-	glVertexPointer(2, GL_FLOAT, 0, pointVertexArray);
-	glDrawArrays(GL_POINTS, 0, 1);
 
-	glEnable(GL_TEXTURE_2D);
+void RendererOpenGL::drawPoint(Point<float> position, Color color)
+{
+	if (isCulled({position, {1, 1}})) { return; }
+
+	const auto vertex = Vertex{{position.x + 0.5f, position.y + 0.5f}, {}, color};
+	addVertices(GL_POINTS, 0, {&vertex, 1});
 }
 
 
 void RendererOpenGL::drawLine(Point<float> startPosition, Point<float> endPosition, Color color, int lineWidth)
 {
-	glDisable(GL_TEXTURE_2D);
-	glEnableClientState(GL_COLOR_ARRAY);
+	if (isCulled(lineBounds(startPosition, endPosition, lineWidth))) { return; }
 
 	const auto offset = Vector<float>{0.5, 0.5};
-	line(startPosition + offset, endPosition + offset, static_cast<float>(lineWidth), color);
+	const auto geometry = line(startPosition + offset, endPosition + offset, static_cast<float>(lineWidth), color);
 
-	glDisableClientState(GL_COLOR_ARRAY);
-	glEnable(GL_TEXTURE_2D);
+	addVertices(GL_TRIANGLES, 0, triangleStripToTriangles(geometry.body));
+	if (geometry.hasCaps)
+	{
+		addVertices(GL_TRIANGLES, 0, triangleStripToTriangles(geometry.caps));
+	}
 }
 
 
-void RendererOpenGL::drawCircle(Point<float> position, float radius, Color color, int numSegments, Vector<float> scale)
+void RendererOpenGL::drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors)
+{
+	checkColorCount(positions.size(), colors);
+	if (positions.empty()) { return; }
+
+	mScratchVertices.clear();
+	mScratchVertices.reserve(positions.size());
+	for (std::size_t i = 0; i < positions.size(); ++i)
+	{
+		const auto& position = positions[i];
+		mScratchVertices.push_back({{position.x + 0.5f, position.y + 0.5f}, {}, colors[colors.size() == 1 ? 0 : i]});
+	}
+	addVertices(GL_POINTS, 0, mScratchVertices);
+}
+
+
+void RendererOpenGL::drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth)
 {
-	/*
-	* See: http://slabode.exofire.net/circle_draw.shtml.
-	*
-	* Modified to support X/Y scaling to draw an ellipse.
-	*/
+	if (endPoints.size() % 2 != 0)
+	{
+		throw std::runtime_error("drawLines requires an even number of end points: " + std::to_string(endPoints.size()));
+	}
 
-	glDisable(GL_TEXTURE_2D);
-	setColor(color);
+	const auto lineCount = endPoints.size() / 2;
+	checkColorCount(lineCount, colors);
+	if (lineCount == 0) { return; }
 
-	const auto theta = Angle::degrees(360) / static_cast<float>(numSegments);
-	const auto direction = getDirectionVector(theta);
-	const auto cosTheta = direction.x;
-	const auto sinTheta = direction.y;
+	const auto offset = Vector<float>{0.5, 0.5};
+	mScratchVertices.clear();
+	for (std::size_t i = 0; i < lineCount; ++i)
+	{
+		const auto geometry = line(endPoints[i * 2] + offset, endPoints[i * 2 + 1] + offset, static_cast<float>(lineWidth), colors[colors.size() == 1 ? 0 : i]);
+		const auto body = triangleStripToTriangles(geometry.body);
+		mScratchVertices.insert(mScratchVertices.end(), body.begin(), body.end());
+		if (geometry.hasCaps)
+		{
+			const auto caps = triangleStripToTriangles(geometry.caps);
+			mScratchVertices.insert(mScratchVertices.end(), caps.begin(), caps.end());
+		}
+	}
+	addVertices(GL_TRIANGLES, 0, mScratchVertices);
+}
 
-	auto offset = Vector<float>{radius, 0};
 
-	std::vector<GLfloat> verts;
-	verts.resize(static_cast<std::size_t>(numSegments) * std::size_t{2});
+void RendererOpenGL::drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
 
-	for (std::size_t i = 0; i < verts.size(); i += 2)
+	mScratchVertices.clear();
+	mScratchVertices.reserve(rects.size() * 8);
+	for (std::size_t i = 0; i < rects.size(); ++i)
 	{
-		const auto point = position + offset.skewBy(scale);
-		verts[i] = point.x;
-		verts[i + 1] = point.y;
+		if (rects[i].empty() || isCulled(rects[i])) { continue; }
 
-		offset = {cosTheta * offset.x - sinTheta * offset.y, sinTheta * offset.x + cosTheta * offset.y};
+		const auto outline = boxOutline(rects[i], colors[colors.size() == 1 ? 0 : i]);
+		mScratchVertices.insert(mScratchVertices.end(), outline.begin(), outline.end());
 	}
+	if (mScratchVertices.empty()) { return; }
+
+	addVertices(GL_LINES, 0, mScratchVertices);
+}
+
 
-	glVertexPointer(2, GL_FLOAT, 0, verts.data());
-	glDrawArrays(GL_LINE_LOOP, 0, numSegments);
+void RendererOpenGL::drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
+
+	mScratchVertices.clear();
+	mScratchVertices.reserve(rects.size() * 6);
+	for (std::size_t i = 0; i < rects.size(); ++i)
+	{
+		if (rects[i].empty() || isCulled(rects[i])) { continue; }
 
-	glEnable(GL_TEXTURE_2D);
+		const auto quad = rectToQuad(rects[i], DefaultTextureRect, colors[colors.size() == 1 ? 0 : i]);
+		mScratchVertices.insert(mScratchVertices.end(), quad.begin(), quad.end());
+	}
+	if (mScratchVertices.empty()) { return; }
+
+	addVertices(GL_TRIANGLES, 0, mScratchVertices);
 }
 
 
-void RendererOpenGL::drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4)
+void RendererOpenGL::drawCircle(Point<float> position, float radius, Color color, int numSegments, Vector<float> scale)
 {
-	glEnableClientState(GL_COLOR_ARRAY);
-	glDisable(GL_TEXTURE_2D);
+	if (numSegments < 1) { return; }
 
-	std::array<GLfloat, 24> colorVertexArray;
+	const auto axes = scale * radius;
+	if (isCulled(position, std::max(std::abs(axes.x), std::abs(axes.y)))) { return; }
 
-	colorVertexArray[0] = c1.red / 255.0f;
-	colorVertexArray[1] = c1.green / 255.0f;
-	colorVertexArray[2] = c1.blue / 255.0f;
-	colorVertexArray[3] = c1.alpha / 255.0f;
+	const auto& unitPoints = unitCircle(numSegments);
 
-	colorVertexArray[4] = c2.red / 255.0f;
-	colorVertexArray[5] = c2.green / 255.0f;
-	colorVertexArray[6] = c2.blue / 255.0f;
-	colorVertexArray[7] = c2.alpha / 255.0f;
+	mScratchVertices.clear();
+	auto previousPoint = position + unitPoints.back().skewBy(axes);
+	for (const auto& unitPoint : unitPoints)
+	{
+		const auto point = position + unitPoint.skewBy(axes);
+		mScratchVertices.push_back({previousPoint, {}, color});
+		mScratchVertices.push_back({point, {}, color});
+		previousPoint = point;
+	}
 
-	colorVertexArray[8] = c3.red / 255.0f;
-	colorVertexArray[9] = c3.green / 255.0f;
-	colorVertexArray[10] = c3.blue / 255.0f;
-	colorVertexArray[11] = c3.alpha / 255.0f;
+	addVertices(GL_LINES, 0, mScratchVertices);
+}
 
 
-	colorVertexArray[12] = c3.red / 255.0f;
-	colorVertexArray[13] = c3.green / 255.0f;
-	colorVertexArray[14] = c3.blue / 255.0f;
-	colorVertexArray[15] = c3.alpha / 255.0f;
+void RendererOpenGL::drawCircleFilled(Point<float> position, float radius, Color color, int numSegments, Vector<float> scale)
+{
+	if (numSegments < 3) { return; }
 
-	colorVertexArray[16] = c4.red / 255.0f;
-	colorVertexArray[17] = c4.green / 255.0f;
-	colorVertexArray[18] = c4.blue / 255.0f;
-	colorVertexArray[19] = c4.alpha / 255.0f;
+	const auto axes = scale * radius;
+	if (isCulled(position, std::max(std::abs(axes.x), std::abs(axes.y)))) { return; }
 
-	colorVertexArray[20] = c1.red / 255.0f;
-	colorVertexArray[21] = c1.green / 255.0f;
-	colorVertexArray[22] = c1.blue / 255.0f;
-	colorVertexArray[23] = c1.alpha / 255.0f;
+	const auto& unitPoints = unitCircle(numSegments);
 
+	mScratchVertices.clear();
+	auto previousPoint = position + unitPoints.back().skewBy(axes);
+	for (const auto& unitPoint : unitPoints)
+	{
+		const auto point = position + unitPoint.skewBy(axes);
+		mScratchVertices.push_back({position, {}, color});
+		mScratchVertices.push_back({previousPoint, {}, color});
+		mScratchVertices.push_back({point, {}, color});
+		previousPoint = point;
+	}
+
+	addVertices(GL_TRIANGLES, 0, mScratchVertices);
+}
+
+
+void RendererOpenGL::drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4)
+{
+	if (isCulled(rect)) { return; }
+
+	const auto p1 = rect.position;
+	const auto p2 = rect.endPoint();
+
+	const std::array<Vertex, 6> vertices{{
+		{p1, {}, c1},
+		{{p1.x, p2.y}, {}, c2},
+		{p2, {}, c3},
 
-	const auto vertexArray = rectToQuad(rect);
-	glColorPointer(4, GL_FLOAT, 0, colorVertexArray.data());
-	drawTexturedQuad(0, vertexArray);
+		{p2, {}, c3},
+		{{p2.x, p1.y}, {}, c4},
+		{p1, {}, c1},
+	}};
 
-	glEnable(GL_TEXTURE_2D);
-	glDisableClientState(GL_COLOR_ARRAY);
+	addVertices(GL_TRIANGLES, 0, vertices);
 }
 
 
 void RendererOpenGL::drawBox(const Rectangle<float>& rect, Color color)
 {
-	if (rect.empty())
+	if (rect.empty() || isCulled(rect))
 	{
 		return;
 	}
 
-	setColor(color);
-	glDisable(GL_TEXTURE_2D);
-
-	const auto p1 = rect.position + Vector{0.5, 0.5}; // OpenGL centers pixels between integer values
-	const auto p2 = rect.endPoint(); // No adjustment here so as to exclude the bottom right sides
-	const GLfloat corners[] = { p1.x, p1.y, p2.x, p1.y, p2.x, p2.y, p1.x, p2.y };
-
-	glVertexPointer(2, GL_FLOAT, 0, &corners);
-	glDrawArrays(GL_LINE_LOOP, 0, 4);
-
-	glEnable(GL_TEXTURE_2D);
+	addVertices(GL_LINES, 0, boxOutline(rect, color));
 }
 
 
 void RendererOpenGL::drawBoxFilled(const Rectangle<float>& rect, Color color)
 {
-	if (rect.empty())
+	if (rect.empty() || isCulled(rect))
 	{
 		return;
 	}
 
-	setColor(color);
-	glDisable(GL_TEXTURE_2D);
-
-	const auto vertexArray = rectToQuad(rect);
-	drawTexturedQuad(0, vertexArray);
-
-	glEnable(GL_TEXTURE_2D);
+	addQuad(0, rect, DefaultTextureRect, color);
 }
 
 
 void RendererOpenGL::drawText(const Font& font, std::string_view text, Point<float> position, Color color)
 {
-	if (text.empty()) { return; }
+	if (isCulled(textBounds(font, font.size(text), position))) { return; }
 
-	setColor(color);
+	mScratchVertices.clear();
+	TextMesh::appendVertices(mScratchVertices, font, text, position, color);
+	if (mScratchVertices.empty()) { return; }
 
-	const auto& gml = font.metrics();
-	if (gml.empty()) { return; }
+	addVertices(GL_TRIANGLES, font.textureId(), mScratchVertices);
+}
 
-	Vector<int> offset{0, 0};
-	for (auto character : text)
-	{
-		if (character == '\n')
-		{
-			offset.y += font.height();
-			offset.x = 0;
-			continue;
-		}
 
-		const auto& gm = gml[std::clamp<std::size_t>(static_cast<uint8_t>(character), 0, 255)];
+/**
+ * Draws the cached glyph geometry of a TextMesh, offset to a position.
+ */
+void RendererOpenGL::drawTextMesh(const TextMesh& textMesh, Point<float> position)
+{
+	if (textMesh.empty() || isCulled(textBounds(*textMesh.font(), textMesh.size(), position))) { return; }
 
-		const auto glyphCellSize = font.glyphCellSize().to<float>();
-		const auto adjustX = (gm.minX < 0) ? gm.minX : 0;
-		const auto vertexArray = rectToQuad({{position.x + offset.x + adjustX, position.y + offset.y}, glyphCellSize});
-		const auto textureCoordArray = rectToQuad(gm.uvRect);
+	const auto vertices = textMesh.vertices();
+	addVertices(GL_TRIANGLES, textMesh.font()->textureId(), vertices);
 
-		drawTexturedQuad(font.textureId(), vertexArray, textureCoordArray);
-		offset.x += gm.advance;
+	const auto offset = position - Point{0.0f, 0.0f};
+	for (auto it = mVertexBatch.end() - static_cast<std::ptrdiff_t>(vertices.size()); it != mVertexBatch.end(); ++it)
+	{
+		it->position = it->position + offset;
 	}
 }
 
 
-void RendererOpenGL::clipRect(const Rectangle<float>& rect)
+void RendererOpenGL::onClipRect(const Rectangle<float>& rect)
 {
-	const auto intRect = rect.to<int>();
-	const auto& position = intRect.position;
-	const auto& clipSize = intRect.size;
-	glScissor(position.x, size().y - (position.y + clipSize.y), clipSize.x, clipSize.y);
+	flush();
+
+	// Clip rects are in drawing coordinates, while the scissor box is in framebuffer
+	// pixels with rows from the bottom. Mapping through the projection also handles
+	// the flipped projection of render targets.
+	const auto viewport = mViewport.to<float>();
+	const auto scale = viewport.size.skewInverseBy(mOrthoBounds.size);
+	const auto toFramebuffer = [&](Point<float> point) {
+		return Point{
+			viewport.position.x + (point.x - mOrthoBounds.position.x) * scale.x,
+			viewport.position.y + (mOrthoBounds.endPoint().y - point.y) * scale.y,
+		};
+	};
+	const auto start = toFramebuffer(rect.position);
+	const auto end = toFramebuffer(rect.endPoint());
+	const auto scissorRect = Rectangle<float>::Create({std::min(start.x, end.x), std::min(start.y, end.y)}, {std::max(start.x, end.x), std::max(start.y, end.y)});
 
-	glEnable(GL_SCISSOR_TEST);
+	auto& glState = Utility<GLStateCache>::get();
+	glState.scissor(scissorRect.to<int>());
+	glState.enable(GL_SCISSOR_TEST);
 }
 
 
-void RendererOpenGL::clipRectClear()
+void RendererOpenGL::onClipRectClear()
 {
-	glDisable(GL_SCISSOR_TEST);
+	flush();
+	Utility<GLStateCache>::get().disable(GL_SCISSOR_TEST);
 }
 
 
 void RendererOpenGL::clearScreen(Color color)
 {
-	glClearColor(static_cast<float>(color.red) / 255.0f, static_cast<float>(color.green) / 255.0f, static_cast<float>(color.blue) / 255.0f, static_cast<float>(color.alpha) / 255.0f);
+	flush();
+	Utility<GLStateCache>::get().clearColor(color);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
 
+/**
+ * Presents the frame, and makes its statistics available through frameStats().
+ *
+ * Queued texture uploads are given their share of the frame first.
+ */
 void RendererOpenGL::update()
 {
+	flush();
+	mCurrentFrameStats.bytesUploaded += Utility<TextureUploadQueue>::get().process();
+	endFrameStats();
 	SDL_GL_SwapWindow(window);
 }
 
 
+/**
+ * Makes the OpenGL context current on the calling thread, and applies any
+ * window resize or resource deletes that arrived while another thread held it.
+ */
+void RendererOpenGL::acquireContext()
+{
+	std::optional<Vector<int>> pendingResize;
+	{
+		std::lock_guard lock{mContextMutex};
+		if (SDL_GL_MakeCurrent(window, sdlOglContext) != 0)
+		{
+			throw std::runtime_error("Unable to make OpenGL context current: " + std::string{SDL_GetError()});
+		}
+		mContextThread = std::this_thread::get_id();
+		Utility<GLStateCache>::get().contextThread(mContextThread);
+		pendingResize = std::exchange(mPendingResize, std::nullopt);
+	}
+
+	Utility<GLStateCache>::get().flushDeletes();
+
+	if (pendingResize)
+	{
+		onResize(*pendingResize);
+	}
+}
+
+
+/**
+ * Submits batched drawing and detaches the OpenGL context from the calling thread.
+ */
+void RendererOpenGL::releaseContext()
+{
+	flush();
+	Utility<GLStateCache>::get().flushDeletes();
+
+	std::lock_guard lock{mContextMutex};
+	SDL_GL_MakeCurrent(window, nullptr);
+	mContextThread = std::thread::id{};
+	Utility<GLStateCache>::get().contextThread(mContextThread);
+}
+
+
 void RendererOpenGL::onResize(Vector<int> newSize)
 {
+	{
+		// Resize events arrive on the thread pumping events, which may not hold the context
+		std::lock_guard lock{mContextMutex};
+		if (mContextThread != std::this_thread::get_id())
+		{
+			mPendingResize = newSize;
+			return;
+		}
+	}
+
 	const auto viewportRect = Rectangle{{0, 0}, newSize};
 	setViewport(viewportRect);
 	setOrthoProjection(viewportRect.to<float>());
@@ -548,14 +963,35 @@ void RendererOpenGL::onResize(Vector<int> newSize)
 
 void RendererOpenGL::setViewport(const Rectangle<int>& viewport)
 {
+	flush();
+	mViewport = viewport;
+
 	const auto& position = viewport.position;
 	const auto& size = viewport.size;
 	glViewport(position.x, position.y, size.x, size.y);
+
+	// The scissor box is in framebuffer pixels, so follows the viewport
+	if (clipDepth() > 0) { applyClipStack(); }
 }
 
 
 void RendererOpenGL::setOrthoProjection(const Rectangle<float>& orthoBounds)
 {
+	flush();
+	mOrthoBounds = orthoBounds;
+	cullArea(orthoBounds);
+	if (clipDepth() > 0) { applyClipStack(); }
+
+	if (mCoreProfile)
+	{
+		const auto projection = orthoMatrix(orthoBounds);
+		glUniformMatrix4fv(mProjectionLocation, 1, GL_FALSE, projection.data());
+		glUseProgram(mInstanceProgram);
+		glUniformMatrix4fv(mInstanceProjectionLocation, 1, GL_FALSE, projection.data());
+		glUseProgram(mShaderProgram);
+		return;
+	}
+
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 	const auto bounds = orthoBounds.to<double>();
@@ -564,14 +1000,265 @@ void RendererOpenGL::setOrthoProjection(const Rectangle<float>& orthoBounds)
 }
 
 
+/**
+ * Draws into an image's texture until resetRenderTarget is called.
+ *
+ * The viewport and projection are set to the image's pixels and clipping is
+ * cleared. The window's viewport and projection are restored afterwards. All
+ * targets share one framebuffer object, with the target texture attached to it.
+ */
+void RendererOpenGL::setRenderTarget(const Image& image)
+{
+	flush();
+
+	if (!mRenderTarget)
+	{
+		mScreenViewport = mViewport;
+		mScreenOrthoBounds = mOrthoBounds;
+	}
+
+	auto& glState = Utility<GLStateCache>::get();
+	if (mRenderTargetFramebuffer == 0)
+	{
+		glGenFramebuffers(1, &mRenderTargetFramebuffer);
+	}
+	const auto textureId = image.renderTargetTextureId();
+	glState.bindFramebuffer(mRenderTargetFramebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+	mRenderTarget = &image;
+
+	// Texture rows start at the bottom of the framebuffer, so the projection is
+	// flipped to keep image rows top down
+	const auto imageSize = image.size();
+	setViewport({{0, 0}, imageSize});
+	const auto targetSize = imageSize.to<float>();
+	setOrthoProjection({{0.0f, targetSize.y}, {targetSize.x, -targetSize.y}});
+	renderTargetClip(true);
+	applyClipStack();
+}
+
+
+void RendererOpenGL::resetRenderTarget()
+{
+	if (!mRenderTarget) { return; }
+
+	flush();
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	Utility<GLStateCache>::get().bindFramebuffer(0);
+	mRenderTarget = nullptr;
+
+	setViewport(mScreenViewport);
+	setOrthoProjection(mScreenOrthoBounds);
+	renderTargetClip(false);
+	applyClipStack();
+}
+
+
+/**
+ * Queues a textured quad for drawing.
+ *
+ * A \c textureId of 0 draws an untextured quad.
+ */
+void RendererOpenGL::addQuad(unsigned int textureId, const Rectangle<float>& vertexRect, const Rectangle<float>& textureRect, Color color)
+{
+	addVertices(GL_TRIANGLES, textureId, rectToQuad(vertexRect, textureRect, color));
+}
+
+
+/**
+ * Appends vertices to the current batch.
+ *
+ * The batch is flushed first if the primitive type, texture or texture wrap mode
+ * differs from what has already been queued, so submission order is preserved exactly.
+ */
+void RendererOpenGL::addVertices(unsigned int primitiveType, unsigned int textureId, std::span<const Vertex> vertices, TextureWrap textureWrap)
+{
+	if (primitiveType != mBatchPrimitiveType || textureId != mBatchTextureId || textureWrap != mBatchTextureWrap)
+	{
+		flush();
+		mBatchPrimitiveType = primitiveType;
+		mBatchTextureId = textureId;
+		mBatchTextureWrap = textureWrap;
+	}
+
+	mVertexBatch.insert(mVertexBatch.end(), vertices.begin(), vertices.end());
+}
+
+
+/**
+ * Points evenly spaced around the unit circle, starting at (1, 0).
+ *
+ * Tables are built once per segment count and kept, so circles only need to
+ * scale and translate them.
+ */
+const std::vector<Vector<float>>& RendererOpenGL::unitCircle(int numSegments)
+{
+	auto& points = mUnitCircles[numSegments];
+	if (points.empty())
+	{
+		points.reserve(static_cast<std::size_t>(numSegments));
+		for (int i = 0; i < numSegments; ++i)
+		{
+			points.push_back(getDirectionVector(Angle::degrees(360.0f * static_cast<float>(i) / static_cast<float>(numSegments))));
+		}
+	}
+	return points;
+}
+
+
+/**
+ * Draws all queued vertices with a single draw call.
+ *
+ * Must be called before any GL state change that would affect queued geometry.
+ */
+void RendererOpenGL::flush()
+{
+	if (mVertexBatch.empty())
+	{
+		return;
+	}
+
+	auto& glState = Utility<GLStateCache>::get();
+	const bool textured = mBatchTextureId != 0;
+
+	if (mCoreProfile)
+	{
+		// Untextured geometry samples a white texture so one shader handles everything
+		if (textured)
+		{
+			glState.textureWrap(mBatchTextureId, mBatchTextureWrap);
+		}
+		glState.bindTexture(textured ? mBatchTextureId : mWhiteTexture);
+
+		const auto offset = mVertexBuffer->write(std::as_bytes(std::span{mVertexBatch}));
+		const auto* base = reinterpret_cast<const std::byte*>(offset);
+		glVertexAttribPointer(PositionAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, position));
+		glVertexAttribPointer(TextureCoordAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, textureCoord));
+		glVertexAttribPointer(ColorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), base + offsetof(Vertex, color));
+		glDrawArrays(mBatchPrimitiveType, 0, static_cast<GLsizei>(mVertexBatch.size()));
+		countDraw(mVertexBatch.size(), mVertexBatch.size() * sizeof(Vertex));
+
+		mVertexBatch.clear();
+		return;
+	}
+
+	if (textured)
+	{
+		glState.enable(GL_TEXTURE_2D);
+		glState.enableClientState(GL_TEXTURE_COORD_ARRAY);
+		glState.textureWrap(mBatchTextureId, mBatchTextureWrap);
+		glState.bindTexture(mBatchTextureId);
+	}
+	else
+	{
+		glState.disable(GL_TEXTURE_2D);
+		glState.disableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+
+	// With a vertex buffer bound, array pointers are byte offsets into the buffer
+	const auto vertexData = std::as_bytes(std::span{mVertexBatch});
+	const auto* base = mVertexBuffer ? reinterpret_cast<const std::byte*>(mVertexBuffer->write(vertexData)) : vertexData.data();
+	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+	if (textured)
+	{
+		glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, textureCoord));
+	}
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+	glDrawArrays(mBatchPrimitiveType, 0, static_cast<GLsizei>(mVertexBatch.size()));
+	countDraw(mVertexBatch.size(), vertexData.size());
+
+	mVertexBatch.clear();
+}
+
+
+void RendererOpenGL::countDraw(std::size_t vertexCount, std::size_t byteCount)
+{
+	++mCurrentFrameStats.drawCalls;
+	mCurrentFrameStats.vertices += vertexCount;
+	mCurrentFrameStats.bytesUploaded += byteCount;
+}
+
+
+/**
+ * Finishes the statistics for the current frame and starts on the next.
+ *
+ * Texture binds and state changes are taken from the GLStateCache counters,
+ * and culled draws from the renderer's count. Both are reset.
+ */
+void RendererOpenGL::endFrameStats()
+{
+	while (!mOpenGpuTimers.empty())
+	{
+		endGpuTimer();
+	}
+
+	auto& glState = Utility<GLStateCache>::get();
+	mCurrentFrameStats.textureBinds = glState.textureBinds();
+	mCurrentFrameStats.stateChanges = glState.issuedCalls();
+	glState.resetCounters();
+	mCurrentFrameStats.culledDraws = culledDrawCount();
+	resetCulledDrawCount();
+
+	// Double buffered: read the previous frame's queries, which the current frame
+	// gave the GPU time to finish, then reuse them for the next frame
+	mGpuTimerFrameIndex = 1 - mGpuTimerFrameIndex;
+	collectGpuTimings(mGpuTimerFrames[mGpuTimerFrameIndex]);
+
+	mFrameStats = std::move(mCurrentFrameStats);
+	mCurrentFrameStats = {};
+}
+
+
+/**
+ * Reads the results of a frame's timer queries, if they are ready, and frees
+ * the queries for reuse.
+ */
+void RendererOpenGL::collectGpuTimings(GpuTimerFrame& timerFrame)
+{
+	if (timerFrame.usedCount == 0) { return; }
+
+	// Queries complete in order, so the last one being ready means they all are
+	GLint available = 0;
+	glGetQueryObjectiv(timerFrame.queries[timerFrame.usedCount - 1].endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available)
+	{
+		for (std::size_t i = 0; i < timerFrame.usedCount; ++i)
+		{
+			const auto& query = timerFrame.queries[i];
+			GLuint64 beginTime = 0;
+			GLuint64 endTime = 0;
+			glGetQueryObjectui64v(query.beginQuery, GL_QUERY_RESULT, &beginTime);
+			glGetQueryObjectui64v(query.endQuery, GL_QUERY_RESULT, &endTime);
+			mCurrentFrameStats.gpuTimings.push_back({query.name, endTime - beginTime});
+		}
+	}
+
+	timerFrame.usedCount = 0;
+}
+
+
+void RendererOpenGL::deleteGpuTimers()
+{
+	for (auto& timerFrame : mGpuTimerFrames)
+	{
+		for (const auto& query : timerFrame.queries)
+		{
+			glDeleteQueries(1, &query.beginQuery);
+			glDeleteQueries(1, &query.endQuery);
+		}
+		timerFrame = {};
+	}
+}
+
+
 void RendererOpenGL::initGL()
 {
-	glClearColor(0, 0, 0, 0);
+	auto& glState = Utility<GLStateCache>::get();
+	glState.invalidate();
+
+	glState.clearColor(Color::NoAlpha);
 	glClear(GL_COLOR_BUFFER_BIT);
-	glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
-	glShadeModel(GL_SMOOTH);
-	glEnable(GL_COLOR_MATERIAL);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glDisable(GL_DEPTH_TEST);
@@ -579,17 +1266,80 @@ void RendererOpenGL::initGL()
 	glEnable(GL_LINE_SMOOTH);
 	glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
 
-	glEnable(GL_TEXTURE_2D);
+	if (mCoreProfile)
+	{
+		initShaderPipeline();
+	}
+	else
+	{
+		glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+		glShadeModel(GL_SMOOTH);
+		glEnable(GL_COLOR_MATERIAL);
+
+		glState.enable(GL_TEXTURE_2D);
+		glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glState.enableClientState(GL_VERTEX_ARRAY);
+		glState.enableClientState(GL_TEXTURE_COORD_ARRAY);
+		glState.enableClientState(GL_COLOR_ARRAY);
 
-	glTexCoordPointer(2, GL_FLOAT, 0, DefaultTextureCoords.data());
+		if (GLEW_VERSION_1_5)
+		{
+			mVertexBuffer = std::make_unique<StreamingVertexBuffer>(VertexBufferCapacity);
+		}
+	}
 
 	RendererOpenGL::onResize(size());
 }
 
 
+/**
+ * Sets up the GLSL pipeline used with a core profile context.
+ *
+ * Batched geometry is drawn with a single shader program, reading vertices from
+ * the streaming vertex buffer through one vertex array object. Image instances
+ * have a second program and vertex array object, reading per-instance attributes
+ * from the same buffer.
+ */
+void RendererOpenGL::initShaderPipeline()
+{
+	if (!GLEW_VERSION_3_3)
+	{
+		throw std::runtime_error("Core profile rendering requires OpenGL 3.3: " + getDriverVersion());
+	}
+
+	mShaderProgram = linkProgram(VertexShaderSource, FragmentShaderSource);
+	glUseProgram(mShaderProgram);
+	glUniform1i(glGetUniformLocation(mShaderProgram, "textureSampler"), 0);
+	mProjectionLocation = glGetUniformLocation(mShaderProgram, "projection");
+
+	mInstanceProgram = linkProgram(InstanceVertexShaderSource, FragmentShaderSource);
+	glUseProgram(mInstanceProgram);
+	glUniform1i(glGetUniformLocation(mInstanceProgram, "textureSampler"), 0);
+	mInstanceProjectionLocation = glGetUniformLocation(mInstanceProgram, "projection");
+
+	// Every instanced attribute advances once per instance
+	glGenVertexArrays(1, &mInstanceVertexArray);
+	glBindVertexArray(mInstanceVertexArray);
+	for (const auto attribute : {InstanceDestinationAttribute, InstanceTextureRectAttribute, InstanceRotationAttribute, InstanceColorAttribute})
+	{
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	glUseProgram(mShaderProgram);
+	glGenVertexArrays(1, &mVertexArray);
+	glBindVertexArray(mVertexArray);
+	mVertexBuffer = std::make_unique<StreamingVertexBuffer>(VertexBufferCapacity);
+	glEnableVertexAttribArray(PositionAttribute);
+	glEnableVertexAttribArray(TextureCoordAttribute);
+	glEnableVertexAttribArray(ColorAttribute);
+
+	auto white = Color::White;
+	mWhiteTexture = generateTexture(&white, 4, 1, 1);
+}
+
+
 void RendererOpenGL::initSdl(Vector<int> resolution, bool fullscreen)
 {
 	if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0)
@@ -613,7 +1363,16 @@ void RendererOpenGL::initSdl(Vector<int> resolution, bool fullscreen)
 
 void RendererOpenGL::initSdlGL(bool vsync)
 {
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+	if (mCoreProfile)
+	{
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+	}
+	else
+	{
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
+	}
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 	SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 4);
@@ -632,6 +1391,8 @@ void RendererOpenGL::initVideo(Vector<int> resolution, bool fullscreen, bool vsy
 {
 	initSdl(resolution, fullscreen);
 	initSdlGL(vsync);
+	// Core profiles don't list extensions through glGetString, which GLEW relies on by default
+	glewExperimental = GL_TRUE;
 	glewInit();
 	initGL();
 
@@ -641,15 +1402,7 @@ void RendererOpenGL::initVideo(Vector<int> resolution, bool fullscreen, bool vsy
 
 namespace
 {
-	void drawTexturedQuad(GLuint textureId, const std::array<GLfloat, 12>& verticies, const std::array<GLfloat, 12>& textureCoords)
-	{
-		glBindTexture(GL_TEXTURE_2D, textureId);
-		glVertexPointer(2, GL_FLOAT, 0, verticies.data());
-		glTexCoordPointer(2, GL_FLOAT, 0, textureCoords.data());
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
-	}
-
-	void line(Point<float> p1, Point<float> p2, float lineWidth, Color color)
+	LineGeometry line(Point<float> p1, Point<float> p2, float lineWidth, Color color)
 	{
 		/**
 		 * The following code was developed by Chris Tsang and lifted from:
@@ -661,10 +1414,8 @@ namespace
 		 * This is drop-in code that may be replaced in the future.
 		 */
 
-		float Cr = color.red / 255.0f;
-		float Cg = color.green / 255.0f;
-		float Cb = color.blue / 255.0f;
-		float Ca = color.alpha / 255.0f;
+		const auto Co = color; // Core color
+		const auto Ce = color.alphaFade(0); // Edge color
 
 		float t = 0.0f;
 		float R = 0.0f;
@@ -772,178 +1523,40 @@ namespace
 		p2.y -= cy * 0.5f;
 
 		// Draw the line by triangle strip
-		float lineVertex[] = {
-			p1.x - tx - Rx - cx,
-			p1.y - ty - Ry - cy, // Fading edge1
-
-			p2.x - tx - Rx + cx,
-			p2.y - ty - Ry + cy,
+		LineGeometry geometry{};
+		geometry.body = {{
+			{{p1.x - tx - Rx - cx, p1.y - ty - Ry - cy}, {}, Ce}, // Fading edge1
+			{{p2.x - tx - Rx + cx, p2.y - ty - Ry + cy}, {}, Ce},
 
-			p1.x - tx - cx,
-			p1.y - ty - cy, // Core
+			{{p1.x - tx - cx, p1.y - ty - cy}, {}, Co}, // Core
+			{{p2.x - tx + cx, p2.y - ty + cy}, {}, Co},
 
-			p2.x - tx + cx,
-			p2.y - ty + cy,
+			{{p1.x + tx - cx, p1.y + ty - cy}, {}, Co},
+			{{p2.x + tx + cx, p2.y + ty + cy}, {}, Co},
 
-			p1.x + tx - cx,
-			p1.y + ty - cy,
-
-			p2.x + tx + cx,
-			p2.y + ty + cy,
-
-			p1.x + tx + Rx - cx,
-			p1.y + ty + Ry - cy, // Fading edge2
-
-			p2.x + tx + Rx + cx,
-			p2.y + ty + Ry + cy,
-		};
-
-		float lineColor[] = {
-			Cr,
-			Cg,
-			Cb,
-			0,
-
-			Cr,
-			Cg,
-			Cb,
-			0,
-
-			Cr,
-			Cg,
-			Cb,
-			Ca,
-
-			Cr,
-			Cg,
-			Cb,
-			Ca,
-
-			Cr,
-			Cg,
-			Cb,
-			Ca,
-
-			Cr,
-			Cg,
-			Cb,
-			Ca,
-
-			Cr,
-			Cg,
-			Cb,
-			0,
-
-			Cr,
-			Cg,
-			Cb,
-			0,
-		};
-
-		glVertexPointer(2, GL_FLOAT, 0, lineVertex);
-		glColorPointer(4, GL_FLOAT, 0, lineColor);
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 8);
+			{{p1.x + tx + Rx - cx, p1.y + ty + Ry - cy}, {}, Ce}, // Fading edge2
+			{{p2.x + tx + Rx + cx, p2.y + ty + Ry + cy}, {}, Ce},
+		}};
 
 		// Line End Caps
-		if (lineWidth > 3.0f)
+		geometry.hasCaps = lineWidth > 3.0f;
+		if (geometry.hasCaps)
 		{
-			float lineVertex2[] = {
-				p1.x - tx - cx,
-				p1.y - ty - cy,
-
-				p1.x + tx + Rx,
-				p1.y + ty + Ry,
-
-				p1.x + tx - cx,
-				p1.y + ty - cy,
-
-				p1.x + tx + Rx - cx,
-				p1.y + ty + Ry - cy,
-
-				p2.x - tx - Rx + cx,
-				p2.y - ty - Ry + cy, // Cap2
-
-				p2.x - tx - Rx,
-				p2.y - ty - Ry,
-
-				p2.x - tx + cx,
-				p2.y - ty + cy,
-
-				p2.x + tx + Rx,
-				p2.y + ty + Ry,
-
-				p2.x + tx + cx,
-				p2.y + ty + cy,
-
-				p2.x + tx + Rx + cx,
-				p2.y + ty + Ry + cy,
-			};
-
-			float lineColor2[] = {
-				Cr,
-				Cg,
-				Cb,
-				0, // Cap1
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-
-				Cr,
-				Cg,
-				Cb,
-				Ca,
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-
-				Cr,
-				Cg,
-				Cb,
-				Ca,
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-
-				Cr,
-				Cg,
-				Cb,
-				0, // Cap2
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-
-				Cr,
-				Cg,
-				Cb,
-				Ca,
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-
-				Cr,
-				Cg,
-				Cb,
-				Ca,
-
-				Cr,
-				Cg,
-				Cb,
-				0,
-			};
-
-			glVertexPointer(2, GL_FLOAT, 0, lineVertex2);
-			glColorPointer(4, GL_FLOAT, 0, lineColor2);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 12);
+			geometry.caps = {{
+				{{p1.x - tx - cx, p1.y - ty - cy}, {}, Ce}, // Cap1
+				{{p1.x + tx + Rx, p1.y + ty + Ry}, {}, Ce},
+				{{p1.x + tx - cx, p1.y + ty - cy}, {}, Co},
+				{{p1.x + tx + Rx - cx, p1.y + ty + Ry - cy}, {}, Ce},
+
+				{{p2.x - tx - Rx + cx, p2.y - ty - Ry + cy}, {}, Co}, // Cap2
+				{{p2.x - tx - Rx, p2.y - ty - Ry}, {}, Ce},
+				{{p2.x - tx + cx, p2.y - ty + cy}, {}, Ce},
+				{{p2.x + tx + Rx, p2.y + ty + Ry}, {}, Ce},
+				{{p2.x + tx + cx, p2.y + ty + cy}, {}, Co},
+				{{p2.x + tx + Rx + cx, p2.y + ty + Ry + cy}, {}, Ce},
+			}};
 		}
+
+		return geometry;
 	}
 }
@@ -10,8 +10,22 @@
 #pragma once
 
 #include "Renderer.h"
-
+#include "GLStateCache.h"
+#include "StreamingVertexBuffer.h"
+#include "Vertex.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 
 using SDL_GLContext = void*;
@@ -30,6 +44,27 @@ namespace NAS2D
 			Vector<int> resolution;
 			bool fullscreen;
 			bool vsync;
+			bool coreProfile;
+		};
+
+		struct GpuTiming
+		{
+			std::string name;
+			std::uint64_t nanoseconds;
+		};
+
+		/**
+		 * Work done by the renderer in one frame, from one update() to the next.
+		 */
+		struct FrameStats
+		{
+			std::size_t drawCalls{0u};
+			std::size_t vertices{0u};
+			std::size_t textureBinds{0u};
+			std::size_t stateChanges{0u};
+			std::size_t bytesUploaded{0u};
+			std::size_t culledDraws{0u};
+			std::vector<GpuTiming> gpuTimings{};
 		};
 
 		static Options ReadConfigurationOptions();
@@ -50,6 +85,14 @@ namespace NAS2D
 		std::string getDriverVersion();
 		std::string getShaderVersion();
 
+		const FrameStats& frameStats() const;
+
+		bool gpuTimingSupported() const;
+		bool gpuTimingEnabled() const;
+		void gpuTimingEnabled(bool enabled);
+		void beginGpuTimer(std::string_view name);
+		void endGpuTimer();
+
 		void drawImage(const Image& image, Point<float> position, float scale = 1.0, Color color = Color::Normal) override;
 
 		void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color = Color::Normal) override;
@@ -61,6 +104,8 @@ namespace NAS2D
 		void drawImageRepeated(const Image& image, const Rectangle<float>& rect) override;
 		void drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source) override;
 
+		void drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset = Vector{0.0f, 0.0f}) override;
+
 		void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) override;
 
 		void drawPoint(Point<float> position, Color color = Color::White) override;
@@ -68,30 +113,115 @@ namespace NAS2D
 		void drawBox(const Rectangle<float>& rect, Color color = Color::White) override;
 		void drawBoxFilled(const Rectangle<float>& rect, Color color = Color::White) override;
 		void drawCircle(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+		void drawCircleFilled(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+
+		void drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors) override;
+		void drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth = 1) override;
+		void drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors) override;
+		void drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors) override;
 
 		void drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4) override;
 
 		void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) override;
+		void drawTextMesh(const TextMesh& textMesh, Point<float> position) override;
 
 		void clearScreen(Color color = Color::Black) override;
 
-		void clipRect(const Rectangle<float>& rect) override;
-		void clipRectClear() override;
-
 		void update() override;
 
+		void acquireContext() override;
+		void releaseContext() override;
+
 		void setViewport(const Rectangle<int>& viewport) override;
 		void setOrthoProjection(const Rectangle<float>& orthoBounds) override;
 
+		void setRenderTarget(const Image& image) override;
+		void resetRenderTarget() override;
+
 	private:
+		/**
+		 * Per-instance attributes read by the instanced drawing shader.
+		 */
+		struct InstanceData
+		{
+			Rectangle<float> destination;
+			Rectangle<float> textureRect;
+			Vector<float> rotation;
+			Color color;
+		};
+
+		struct GpuTimerQuery
+		{
+			std::string name{};
+			unsigned int beginQuery{0u};
+			unsigned int endQuery{0u};
+		};
+
+		/**
+		 * Timer queries issued during one frame. Queries are reused from frame to frame.
+		 */
+		struct GpuTimerFrame
+		{
+			std::vector<GpuTimerQuery> queries{};
+			std::size_t usedCount{0u};
+		};
+
 		void initGL();
 		void initSdl(Vector<int> resolution, bool fullscreen);
 		void initSdlGL(bool vsync);
 		void initVideo(Vector<int> resolution, bool fullscreen, bool vsync);
+		void initShaderPipeline();
 
 		void onResize(Vector<int> newSize) override;
+		void onClipRect(const Rectangle<float>& rect) override;
+		void onClipRectClear() override;
+
+		void addQuad(unsigned int textureId, const Rectangle<float>& vertexRect, const Rectangle<float>& textureRect, Color color);
+		void addVertices(unsigned int primitiveType, unsigned int textureId, std::span<const Vertex> vertices, TextureWrap textureWrap = TextureWrap::ClampToEdge);
+		void flush();
+		void countDraw(std::size_t vertexCount, std::size_t byteCount);
+		void endFrameStats();
+		void collectGpuTimings(GpuTimerFrame& timerFrame);
+		void deleteGpuTimers();
 
+		const std::vector<Vector<float>>& unitCircle(int numSegments);
 
 		SDL_GLContext sdlOglContext{};
+		std::thread::id mContextThread{std::this_thread::get_id()};
+		std::optional<Vector<int>> mPendingResize{};
+		std::mutex mContextMutex{};
+
+		std::vector<Vertex> mVertexBatch{};
+		unsigned int mBatchPrimitiveType{0u};
+		unsigned int mBatchTextureId{0u};
+		TextureWrap mBatchTextureWrap{TextureWrap::ClampToEdge};
+		std::vector<Vertex> mScratchVertices{};
+		std::map<int, std::vector<Vector<float>>> mUnitCircles{};
+		std::vector<InstanceData> mInstanceData{};
+
+		std::unique_ptr<StreamingVertexBuffer> mVertexBuffer{};
+
+		Rectangle<int> mViewport{};
+		Rectangle<float> mOrthoBounds{};
+		const Image* mRenderTarget{nullptr};
+		unsigned int mRenderTargetFramebuffer{0u};
+		Rectangle<int> mScreenViewport{};
+		Rectangle<float> mScreenOrthoBounds{};
+
+		bool mCoreProfile{false};
+		unsigned int mShaderProgram{0u};
+		unsigned int mVertexArray{0u};
+		unsigned int mWhiteTexture{0u};
+		int mProjectionLocation{-1};
+		unsigned int mInstanceProgram{0u};
+		unsigned int mInstanceVertexArray{0u};
+		int mInstanceProjectionLocation{-1};
+
+		FrameStats mFrameStats{};
+		FrameStats mCurrentFrameStats{};
+		bool mGpuTimingEnabled{false};
+		std::array<GpuTimerFrame, 2> mGpuTimerFrames{};
+		std::size_t mGpuTimerFrameIndex{0u};
+		std::vector<std::size_t> mOpenGpuTimers{};
 	};
 }
@@ -0,0 +1,160 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "RendererPipelined.h"
+
+#include <stdexcept>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+/**
+ * \param renderer	Renderer to draw with. Its context must be current on the calling thread.
+ */
+RendererPipelined::RendererPipelined(std::unique_ptr<Renderer> renderer) :
+	mRenderer{std::move(renderer)}
+{
+	if (!mRenderer)
+	{
+		throw std::runtime_error("RendererPipelined requires a renderer to draw with");
+	}
+
+	shareWindow(*mRenderer);
+	mRenderThread = std::thread{&RendererPipelined::renderLoop, this};
+}
+
+
+RendererPipelined::~RendererPipelined()
+{
+	{
+		std::unique_lock lock{mMutex};
+		mFrameChanged.wait(lock, [this]() { return !mFrameSubmitted; });
+		mStopping = true;
+	}
+	mFrameChanged.notify_all();
+	mRenderThread.join();
+
+	if (!mHoldingContext)
+	{
+		mRenderer->acquireContext();
+	}
+}
+
+
+/**
+ * Gets the wrapped renderer.
+ *
+ * Only safe to use directly after finish(), and before the next update().
+ */
+Renderer& RendererPipelined::renderer()
+{
+	return *mRenderer;
+}
+
+
+/**
+ * Ends the frame and hands it to the render thread.
+ *
+ * Waits for the previous frame to finish drawing first, so the caller stays at
+ * most one frame ahead. Rethrows any exception thrown while drawing it.
+ */
+void RendererPipelined::update()
+{
+	RendererRecording::update();
+	submit();
+}
+
+
+/**
+ * Draws everything recorded so far, then makes the wrapped renderer's context
+ * current on the calling thread until the next update().
+ */
+void RendererPipelined::finish()
+{
+	submit();
+	waitForFrame();
+
+	if (!mHoldingContext)
+	{
+		mRenderer->acquireContext();
+		mHoldingContext = true;
+	}
+}
+
+
+/**
+ * Tracks the window size for callers. The wrapped renderer handles the resize
+ * itself, the next time it holds its context.
+ */
+void RendererPipelined::onResize(Vector<int> newSize)
+{
+	setResolution(newSize);
+}
+
+
+void RendererPipelined::submit()
+{
+	waitForFrame();
+	swapCommands(mSubmitted);
+
+	if (mHoldingContext)
+	{
+		mRenderer->releaseContext();
+		mHoldingContext = false;
+	}
+
+	{
+		std::lock_guard lock{mMutex};
+		mFrameSubmitted = true;
+	}
+	mFrameChanged.notify_all();
+}
+
+
+void RendererPipelined::waitForFrame()
+{
+	std::unique_lock lock{mMutex};
+	mFrameChanged.wait(lock, [this]() { return !mFrameSubmitted; });
+	if (mError)
+	{
+		std::rethrow_exception(std::exchange(mError, nullptr));
+	}
+}
+
+
+void RendererPipelined::renderLoop()
+{
+	std::unique_lock lock{mMutex};
+	while (true)
+	{
+		mFrameChanged.wait(lock, [this]() { return mFrameSubmitted || mStopping; });
+		if (!mFrameSubmitted) { return; }
+		lock.unlock();
+
+		std::exception_ptr error;
+		try
+		{
+			mRenderer->acquireContext();
+			mSubmitted.replay(*mRenderer);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		mRenderer->releaseContext();
+		mSubmitted.clearResources();
+
+		lock.lock();
+		mError = error;
+		mFrameSubmitted = false;
+		mFrameChanged.notify_all();
+	}
+}
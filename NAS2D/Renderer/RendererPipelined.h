@@ -0,0 +1,79 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "RendererRecording.h"
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+namespace NAS2D
+{
+	/**
+	 * Renderer that draws on a dedicated render thread, one frame behind.
+	 *
+	 * Draw calls are recorded on the calling thread. Each update() hands the
+	 * recorded frame to the render thread, which replays it into the wrapped
+	 * renderer while the caller goes on to record the next frame. The wrapped
+	 * renderer's context is current on the render thread only while it draws.
+	 *
+	 * \warning	This changes the rules for code that draws, so it is opt in. With
+	 *			the usual renderers, drawing is finished when a draw call returns.
+	 *			Here it is finished only once the next update() returns, or after
+	 *			finish(). Until then:
+	 *			- Images, fonts and text meshes drawn must stay alive and unchanged.
+	 *			  Freeing a temporary Image right after drawing it is a use after free.
+	 *			- Fonts must not be loaded, and image pixels must not be read or
+	 *			  edited, since those need the OpenGL context or image state the
+	 *			  render thread is using. Call finish() first.
+	 *
+	 * Deleting resources is safe at any time. GLStateCache queues OpenGL deletes
+	 * for the thread holding the context, and the texture atlas and upload queue
+	 * are locked.
+	 *
+	 * Not supported on macOS, where the OpenGL context must stay on the main
+	 * thread. Application uses it only if the application opts in, and the
+	 * \c pipelined graphics option is set.
+	 */
+	class RendererPipelined : public RendererRecording
+	{
+	public:
+		explicit RendererPipelined(std::unique_ptr<Renderer> renderer);
+		~RendererPipelined() override;
+
+		Renderer& renderer();
+
+		void update() override;
+		void finish() override;
+
+	protected:
+		void onResize(Vector<int> newSize) override;
+
+	private:
+		void submit();
+		void waitForFrame();
+		void renderLoop();
+
+		std::unique_ptr<Renderer> mRenderer;
+		RendererRecording mSubmitted{};
+		bool mHoldingContext{true};
+
+		std::mutex mMutex{};
+		std::condition_variable mFrameChanged{};
+		bool mFrameSubmitted{false};
+		bool mStopping{false};
+		std::exception_ptr mError{};
+		std::thread mRenderThread{};
+	};
+}
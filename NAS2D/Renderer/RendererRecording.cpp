@@ -0,0 +1,950 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "RendererRecording.h"
+#include "TextMesh.h"
+
+#include "../Math/Angle.h"
+#include "../Filesystem.h"
+#include "../Utility.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	static_assert(std::is_trivially_copyable_v<RendererRecording::Command>);
+	// No padding, so serialized commands have no uninitialized bytes
+	static_assert(sizeof(RendererRecording::Command) == 72);
+	static_assert(std::is_trivially_copyable_v<ImageInstance>);
+	static_assert(sizeof(ImageInstance) == 32);
+
+	constexpr std::string_view FileSignature{"NAS2DREC"};
+	constexpr std::uint32_t FileVersion = 4;
+
+
+	struct FileHeader
+	{
+		char signature[8];
+		std::uint32_t version;
+		std::uint32_t commandCount;
+		std::uint32_t pointCount;
+		std::uint32_t rectCount;
+		std::uint32_t colorCount;
+		std::uint32_t instanceCount;
+		std::uint32_t textSize;
+	};
+
+
+	RendererRecording::Command blankCommand(RendererRecording::CommandType type)
+	{
+		return {type, RendererRecording::NoResource, RendererRecording::NoResource, 0, {}, {}, {}, {}};
+	}
+
+
+	template <typename T>
+	void append(std::string& data, const T& value)
+	{
+		data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+
+	template <typename T>
+	void appendItems(std::string& data, const std::vector<T>& items)
+	{
+		data.append(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(T));
+	}
+
+
+	/**
+	 * Copies items into an item buffer, and returns the offset of the first one.
+	 */
+	template <typename T>
+	std::uint32_t storeItems(std::vector<T>& buffer, std::span<const T> items)
+	{
+		const auto offset = static_cast<std::uint32_t>(buffer.size());
+		buffer.insert(buffer.end(), items.begin(), items.end());
+		return offset;
+	}
+
+
+	template <typename T>
+	std::vector<T> readItems(std::string_view data, std::size_t& offset, std::uint32_t count)
+	{
+		std::vector<T> items(count, T{});
+		std::memcpy(items.data(), data.data() + offset, items.size() * sizeof(T));
+		offset += items.size() * sizeof(T);
+		return items;
+	}
+
+
+	template <typename T>
+	std::span<const T> itemRange(const std::vector<T>& buffer, std::uint32_t offset, std::size_t count)
+	{
+		return std::span<const T>{buffer}.subspan(offset, count);
+	}
+
+
+	bool isBulkPrimitive(RendererRecording::CommandType type)
+	{
+		using CommandType = RendererRecording::CommandType;
+		return type == CommandType::DrawPoints || type == CommandType::DrawLines || type == CommandType::DrawBoxes || type == CommandType::DrawBoxesFilled;
+	}
+
+
+	bool sameInstance(const ImageInstance& instance, const ImageInstance& other)
+	{
+		return instance.position == other.position && instance.subImageRect == other.subImageRect && instance.angle.degrees() == other.angle.degrees() && instance.color == other.color;
+	}
+}
+
+
+RendererRecording::RendererRecording() = default;
+
+
+RendererRecording::RendererRecording(Vector<int> resolution)
+{
+	mResolution = resolution;
+}
+
+
+RendererRecording::~RendererRecording() = default;
+
+
+void RendererRecording::drawImage(const Image& image, Point<float> position, float scale, Color color)
+{
+	auto& command = record(CommandType::DrawImage);
+	command.resource = imageIndex(image);
+	command.rect.position = position;
+	command.values[0] = scale;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color)
+{
+	auto& command = record(CommandType::DrawSubImage);
+	command.resource = imageIndex(image);
+	command.rect.position = raster;
+	command.source = subImageRect;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color)
+{
+	auto& command = record(CommandType::DrawSubImageRotated);
+	command.resource = imageIndex(image);
+	command.rect.position = raster;
+	command.source = subImageRect;
+	command.values[0] = angle.degrees();
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color, float scale)
+{
+	auto& command = record(CommandType::DrawImageRotated);
+	command.resource = imageIndex(image);
+	command.rect.position = position;
+	command.values = {angle.degrees(), scale};
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color)
+{
+	auto& command = record(CommandType::DrawImageStretched);
+	command.resource = imageIndex(image);
+	command.rect = rect;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawImageRepeated(const Image& image, const Rectangle<float>& rect)
+{
+	auto& command = record(CommandType::DrawImageRepeated);
+	command.resource = imageIndex(image);
+	command.rect = rect;
+}
+
+
+void RendererRecording::drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source)
+{
+	auto& command = record(CommandType::DrawSubImageRepeated);
+	command.resource = imageIndex(image);
+	command.rect = destination;
+	command.source = source;
+}
+
+
+void RendererRecording::drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint)
+{
+	auto& command = record(CommandType::DrawImageToImage);
+	command.resource = imageIndex(source);
+	command.secondaryResource = imageIndex(destination);
+	command.rect.position = dstPoint;
+}
+
+
+void RendererRecording::drawPoint(Point<float> position, Color color)
+{
+	auto& command = record(CommandType::DrawPoint);
+	command.rect.position = position;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawLine(Point<float> startPosition, Point<float> endPosition, Color color, int line_width)
+{
+	auto& command = record(CommandType::DrawLine);
+	command.rect = Rectangle<float>::Create(startPosition, endPosition);
+	command.count = line_width;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawBox(const Rectangle<float>& rect, Color color)
+{
+	auto& command = record(CommandType::DrawBox);
+	command.rect = rect;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawBoxFilled(const Rectangle<float>& rect, Color color)
+{
+	auto& command = record(CommandType::DrawBoxFilled);
+	command.rect = rect;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawCircle(Point<float> position, float radius, Color color, int num_segments, Vector<float> scale)
+{
+	auto& command = record(CommandType::DrawCircle);
+	command.rect = {position, scale};
+	command.values[0] = radius;
+	command.count = num_segments;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawCircleFilled(Point<float> position, float radius, Color color, int num_segments, Vector<float> scale)
+{
+	auto& command = record(CommandType::DrawCircleFilled);
+	command.rect = {position, scale};
+	command.values[0] = radius;
+	command.count = num_segments;
+	command.colors[0] = color;
+}
+
+
+void RendererRecording::drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4)
+{
+	auto& command = record(CommandType::DrawGradient);
+	command.rect = rect;
+	command.colors = {c1, c2, c3, c4};
+}
+
+
+void RendererRecording::drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors)
+{
+	checkColorCount(positions.size(), colors);
+	if (positions.empty()) { return; }
+
+	auto& command = record(CommandType::DrawPoints);
+	command.secondaryResource = storeItems(mPoints, positions);
+	command.count = static_cast<std::int32_t>(positions.size());
+	recordColors(command, colors);
+}
+
+
+void RendererRecording::drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth)
+{
+	if (endPoints.size() % 2 != 0)
+	{
+		throw std::runtime_error("drawLines requires an even number of end points: " + std::to_string(endPoints.size()));
+	}
+	checkColorCount(endPoints.size() / 2, colors);
+	if (endPoints.empty()) { return; }
+
+	auto& command = record(CommandType::DrawLines);
+	command.secondaryResource = storeItems(mPoints, endPoints);
+	command.count = static_cast<std::int32_t>(endPoints.size() / 2);
+	command.values[0] = static_cast<float>(lineWidth);
+	recordColors(command, colors);
+}
+
+
+void RendererRecording::drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
+	if (rects.empty()) { return; }
+
+	auto& command = record(CommandType::DrawBoxes);
+	command.secondaryResource = storeItems(mRects, rects);
+	command.count = static_cast<std::int32_t>(rects.size());
+	recordColors(command, colors);
+}
+
+
+void RendererRecording::drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors)
+{
+	checkColorCount(rects.size(), colors);
+	if (rects.empty()) { return; }
+
+	auto& command = record(CommandType::DrawBoxesFilled);
+	command.secondaryResource = storeItems(mRects, rects);
+	command.count = static_cast<std::int32_t>(rects.size());
+	recordColors(command, colors);
+}
+
+
+void RendererRecording::drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset)
+{
+	if (instances.empty()) { return; }
+
+	auto& command = record(CommandType::DrawImageInstances);
+	command.resource = imageIndex(image);
+	command.secondaryResource = storeItems(mInstances, instances);
+	command.count = static_cast<std::int32_t>(instances.size());
+	command.rect.size = offset;
+}
+
+
+void RendererRecording::drawText(const Font& font, std::string_view text, Point<float> position, Color color)
+{
+	auto& command = record(CommandType::DrawText);
+	command.resource = fontIndex(font);
+	command.secondaryResource = static_cast<std::uint32_t>(mTextBuffer.size());
+	command.count = static_cast<std::int32_t>(text.size());
+	command.rect.position = position;
+	command.colors[0] = color;
+	mTextBuffer.append(text);
+}
+
+
+void RendererRecording::drawTextMesh(const TextMesh& textMesh, Point<float> position)
+{
+	if (textMesh.font() == nullptr) { return; }
+
+	auto& command = record(CommandType::DrawTextMesh);
+	command.resource = textMeshIndex(textMesh);
+	command.secondaryResource = static_cast<std::uint32_t>(mTextBuffer.size());
+	command.count = static_cast<std::int32_t>(textMesh.text().size());
+	command.rect.position = position;
+	command.colors[0] = textMesh.color();
+	mTextBuffer.append(textMesh.text());
+}
+
+
+void RendererRecording::clearScreen(Color color)
+{
+	record(CommandType::ClearScreen).colors[0] = color;
+}
+
+
+void RendererRecording::onClipRect(const Rectangle<float>& rect)
+{
+	record(CommandType::ClipRect).rect = rect;
+}
+
+
+void RendererRecording::onClipRectClear()
+{
+	record(CommandType::ClipRectClear);
+}
+
+
+void RendererRecording::update()
+{
+	record(CommandType::Update);
+}
+
+
+void RendererRecording::setViewport(const Rectangle<int>& viewport)
+{
+	record(CommandType::SetViewport).rect = viewport.to<float>();
+}
+
+
+void RendererRecording::setOrthoProjection(const Rectangle<float>& orthoBounds)
+{
+	record(CommandType::SetOrthoProjection).rect = orthoBounds;
+}
+
+
+void RendererRecording::setRenderTarget(const Image& image)
+{
+	auto& command = record(CommandType::SetRenderTarget);
+	command.resource = imageIndex(image);
+	renderTargetClip(true);
+}
+
+
+void RendererRecording::resetRenderTarget()
+{
+	record(CommandType::ResetRenderTarget);
+	renderTargetClip(false);
+}
+
+
+std::span<const RendererRecording::Command> RendererRecording::commands() const
+{
+	return mCommands;
+}
+
+
+/**
+ * Gets the text of a DrawText or DrawTextMesh command.
+ */
+std::string_view RendererRecording::text(const Command& command) const
+{
+	if (command.type != CommandType::DrawText && command.type != CommandType::DrawTextMesh)
+	{
+		return {};
+	}
+	return std::string_view{mTextBuffer}.substr(command.secondaryResource, static_cast<std::size_t>(command.count));
+}
+
+
+/**
+ * Gets the points of a DrawPoints command, or the end points of a DrawLines command.
+ */
+std::span<const Point<float>> RendererRecording::points(const Command& command) const
+{
+	const auto count = static_cast<std::size_t>(command.count);
+	switch (command.type)
+	{
+	case CommandType::DrawPoints:
+		return itemRange(mPoints, command.secondaryResource, count);
+	case CommandType::DrawLines:
+		return itemRange(mPoints, command.secondaryResource, count * 2);
+	default:
+		return {};
+	}
+}
+
+
+/**
+ * Gets the boxes of a DrawBoxes or DrawBoxesFilled command.
+ */
+std::span<const Rectangle<float>> RendererRecording::rects(const Command& command) const
+{
+	if (command.type != CommandType::DrawBoxes && command.type != CommandType::DrawBoxesFilled)
+	{
+		return {};
+	}
+	return itemRange(mRects, command.secondaryResource, static_cast<std::size_t>(command.count));
+}
+
+
+/**
+ * Gets the colors of a bulk draw command, either one per item or a single color.
+ */
+std::span<const Color> RendererRecording::colors(const Command& command) const
+{
+	if (!isBulkPrimitive(command.type))
+	{
+		return {};
+	}
+	if (command.resource == NoResource)
+	{
+		return std::span{command.colors}.first(1);
+	}
+	return itemRange(mColors, command.resource, static_cast<std::size_t>(command.count));
+}
+
+
+/**
+ * Gets the instances of a DrawImageInstances command.
+ */
+std::span<const ImageInstance> RendererRecording::instances(const Command& command) const
+{
+	if (command.type != CommandType::DrawImageInstances)
+	{
+		return {};
+	}
+	return itemRange(mInstances, command.secondaryResource, static_cast<std::size_t>(command.count));
+}
+
+
+std::size_t RendererRecording::count(CommandType type) const
+{
+	return mCounts[static_cast<std::size_t>(type)];
+}
+
+
+/**
+ * Number of completed frames, as marked by calls to update().
+ */
+std::size_t RendererRecording::frameCount() const
+{
+	return count(CommandType::Update);
+}
+
+
+/**
+ * Discards all recorded commands. Resource tables are kept.
+ */
+void RendererRecording::clear()
+{
+	mCommands.clear();
+	mTextBuffer.clear();
+	mPoints.clear();
+	mRects.clear();
+	mColors.clear();
+	mInstances.clear();
+	mCounts.fill(0);
+}
+
+
+/**
+ * Discards all recorded commands, and the resource tables they index into.
+ *
+ * Use between frames to stop holding pointers to resources that are no longer
+ * drawn. Buffer capacity is kept.
+ */
+void RendererRecording::clearResources()
+{
+	clear();
+	mImages.clear();
+	mFonts.clear();
+	mTextMeshes.clear();
+	mImageIndexes.clear();
+	mFontIndexes.clear();
+	mTextMeshIndexes.clear();
+}
+
+
+/**
+ * Exchanges recorded commands and resource tables with another recording.
+ *
+ * Buffers are swapped rather than copied, so a pair of recordings can be used
+ * to double buffer frames.
+ */
+void RendererRecording::swapCommands(RendererRecording& other)
+{
+	std::swap(mCommands, other.mCommands);
+	std::swap(mTextBuffer, other.mTextBuffer);
+	std::swap(mPoints, other.mPoints);
+	std::swap(mRects, other.mRects);
+	std::swap(mColors, other.mColors);
+	std::swap(mInstances, other.mInstances);
+	std::swap(mCounts, other.mCounts);
+	std::swap(mImages, other.mImages);
+	std::swap(mFonts, other.mFonts);
+	std::swap(mTextMeshes, other.mTextMeshes);
+	std::swap(mImageIndexes, other.mImageIndexes);
+	std::swap(mFontIndexes, other.mFontIndexes);
+	std::swap(mTextMeshIndexes, other.mTextMeshIndexes);
+}
+
+
+/**
+ * Issues all recorded commands, in order, to another renderer.
+ */
+void RendererRecording::replay(Renderer& renderer) const
+{
+	for (const auto& command : mCommands)
+	{
+		const auto& rect = command.rect;
+		const auto color = command.colors[0];
+		switch (command.type)
+		{
+		case CommandType::DrawImage:
+			renderer.drawImage(image(command.resource), rect.position, command.values[0], color);
+			break;
+		case CommandType::DrawSubImage:
+			renderer.drawSubImage(image(command.resource), rect.position, command.source, color);
+			break;
+		case CommandType::DrawSubImageRotated:
+			renderer.drawSubImageRotated(image(command.resource), rect.position, command.source, Angle::degrees(command.values[0]), color);
+			break;
+		case CommandType::DrawImageRotated:
+			renderer.drawImageRotated(image(command.resource), rect.position, Angle::degrees(command.values[0]), color, command.values[1]);
+			break;
+		case CommandType::DrawImageStretched:
+			renderer.drawImageStretched(image(command.resource), rect, color);
+			break;
+		case CommandType::DrawImageRepeated:
+			renderer.drawImageRepeated(image(command.resource), rect);
+			break;
+		case CommandType::DrawSubImageRepeated:
+			renderer.drawSubImageRepeated(image(command.resource), rect, command.source);
+			break;
+		case CommandType::DrawImageToImage:
+			renderer.drawImageToImage(image(command.resource), image(command.secondaryResource), rect.position);
+			break;
+		case CommandType::DrawPoint:
+			renderer.drawPoint(rect.position, color);
+			break;
+		case CommandType::DrawLine:
+			renderer.drawLine(rect.position, rect.endPoint(), color, command.count);
+			break;
+		case CommandType::DrawBox:
+			renderer.drawBox(rect, color);
+			break;
+		case CommandType::DrawBoxFilled:
+			renderer.drawBoxFilled(rect, color);
+			break;
+		case CommandType::DrawCircle:
+			renderer.drawCircle(rect.position, command.values[0], color, command.count, rect.size);
+			break;
+		case CommandType::DrawCircleFilled:
+			renderer.drawCircleFilled(rect.position, command.values[0], color, command.count, rect.size);
+			break;
+		case CommandType::DrawGradient:
+			renderer.drawGradient(rect, command.colors[0], command.colors[1], command.colors[2], command.colors[3]);
+			break;
+		case CommandType::DrawText:
+			renderer.drawText(font(command.resource), text(command), rect.position, color);
+			break;
+		case CommandType::ClearScreen:
+			renderer.clearScreen(color);
+			break;
+		case CommandType::ClipRect:
+			renderer.clipRect(rect);
+			break;
+		case CommandType::ClipRectClear:
+			renderer.clipRectClear();
+			break;
+		case CommandType::Update:
+			renderer.update();
+			break;
+		case CommandType::SetViewport:
+			renderer.setViewport(rect.to<int>());
+			break;
+		case CommandType::SetOrthoProjection:
+			renderer.setOrthoProjection(rect);
+			break;
+		case CommandType::SetRenderTarget:
+			renderer.setRenderTarget(image(command.resource));
+			break;
+		case CommandType::ResetRenderTarget:
+			renderer.resetRenderTarget();
+			break;
+		case CommandType::DrawPoints:
+			renderer.drawPoints(points(command), colors(command));
+			break;
+		case CommandType::DrawLines:
+			renderer.drawLines(points(command), colors(command), static_cast<int>(command.values[0]));
+			break;
+		case CommandType::DrawBoxes:
+			renderer.drawBoxes(rects(command), colors(command));
+			break;
+		case CommandType::DrawBoxesFilled:
+			renderer.drawBoxesFilled(rects(command), colors(command));
+			break;
+		case CommandType::DrawImageInstances:
+			renderer.drawImageInstances(image(command.resource), instances(command), rect.size);
+			break;
+		case CommandType::DrawTextMesh:
+			renderer.drawTextMesh(textMesh(command.resource), rect.position);
+			break;
+		}
+	}
+}
+
+
+/**
+ * Compares two recordings command by command.
+ *
+ * \return	Indexes of commands that differ. Commands present in only one of the
+ *			recordings are included.
+ */
+std::vector<std::size_t> RendererRecording::differences(const RendererRecording& other) const
+{
+	std::vector<std::size_t> indexes;
+	const auto commonCount = std::min(mCommands.size(), other.mCommands.size());
+	for (std::size_t i = 0; i < commonCount; ++i)
+	{
+		if (!sameCommand(mCommands[i], other, other.mCommands[i]))
+		{
+			indexes.push_back(i);
+		}
+	}
+	for (auto i = commonCount; i < std::max(mCommands.size(), other.mCommands.size()); ++i)
+	{
+		indexes.push_back(i);
+	}
+	return indexes;
+}
+
+
+/**
+ * Converts commands, bulk draw items and text to a binary blob. Resources are
+ * not included.
+ *
+ * \note	Data is stored in native byte order.
+ */
+std::string RendererRecording::serialize() const
+{
+	FileHeader header{
+		{},
+		FileVersion,
+		static_cast<std::uint32_t>(mCommands.size()),
+		static_cast<std::uint32_t>(mPoints.size()),
+		static_cast<std::uint32_t>(mRects.size()),
+		static_cast<std::uint32_t>(mColors.size()),
+		static_cast<std::uint32_t>(mInstances.size()),
+		static_cast<std::uint32_t>(mTextBuffer.size())
+	};
+	std::copy(FileSignature.begin(), FileSignature.end(), header.signature);
+
+	std::string data;
+	append(data, header);
+	appendItems(data, mCommands);
+	appendItems(data, mPoints);
+	appendItems(data, mRects);
+	appendItems(data, mColors);
+	appendItems(data, mInstances);
+	data.append(mTextBuffer);
+	return data;
+}
+
+
+/**
+ * Replaces recorded commands, bulk draw items and text with those from
+ * serialized data. Resource tables are kept.
+ */
+void RendererRecording::deserialize(std::string_view data)
+{
+	FileHeader header;
+	if (data.size() < sizeof(header))
+	{
+		throw std::runtime_error("Recording data is too short for header");
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	if (std::string_view{header.signature, sizeof(header.signature)} != FileSignature || header.version != FileVersion)
+	{
+		throw std::runtime_error("Recording data has an unrecognized signature or version");
+	}
+
+	const auto itemBytes = std::size_t{header.commandCount} * sizeof(Command) +
+		std::size_t{header.pointCount} * sizeof(Point<float>) +
+		std::size_t{header.rectCount} * sizeof(Rectangle<float>) +
+		std::size_t{header.colorCount} * sizeof(Color) +
+		std::size_t{header.instanceCount} * sizeof(ImageInstance);
+	if (data.size() != sizeof(header) + itemBytes + header.textSize)
+	{
+		throw std::runtime_error("Recording data size does not match header");
+	}
+
+	auto offset = sizeof(header);
+	auto commands = readItems<Command>(data, offset, header.commandCount);
+	auto points = readItems<Point<float>>(data, offset, header.pointCount);
+	auto rects = readItems<Rectangle<float>>(data, offset, header.rectCount);
+	auto colors = readItems<Color>(data, offset, header.colorCount);
+	auto instances = readItems<ImageInstance>(data, offset, header.instanceCount);
+
+	const auto checkRange = [](std::uint32_t first, std::size_t count, std::size_t size, const std::string& what) {
+		if (first > size || count > size - first)
+		{
+			throw std::runtime_error("Recording data contains " + what + " out of range");
+		}
+	};
+
+	std::array<std::size_t, CommandTypeCount> counts{};
+	for (const auto& command : commands)
+	{
+		const auto typeIndex = static_cast<std::size_t>(command.type);
+		if (typeIndex >= CommandTypeCount)
+		{
+			throw std::runtime_error("Recording data contains an unknown command type: " + std::to_string(typeIndex));
+		}
+
+		const auto count = static_cast<std::size_t>(command.count);
+		const auto usesItems = command.type == CommandType::DrawText || command.type == CommandType::DrawTextMesh || isBulkPrimitive(command.type) || command.type == CommandType::DrawImageInstances;
+		if (usesItems && command.count < 0)
+		{
+			throw std::runtime_error("Recording data contains a negative item count");
+		}
+
+		switch (command.type)
+		{
+		case CommandType::DrawText:
+		case CommandType::DrawTextMesh:
+			checkRange(command.secondaryResource, count, header.textSize, "text");
+			break;
+		case CommandType::DrawPoints:
+			checkRange(command.secondaryResource, count, points.size(), "points");
+			break;
+		case CommandType::DrawLines:
+			checkRange(command.secondaryResource, count * 2, points.size(), "points");
+			break;
+		case CommandType::DrawBoxes:
+		case CommandType::DrawBoxesFilled:
+			checkRange(command.secondaryResource, count, rects.size(), "rects");
+			break;
+		case CommandType::DrawImageInstances:
+			checkRange(command.secondaryResource, count, instances.size(), "instances");
+			break;
+		default:
+			break;
+		}
+		if (isBulkPrimitive(command.type) && command.resource != NoResource)
+		{
+			checkRange(command.resource, count, colors.size(), "colors");
+		}
+		++counts[typeIndex];
+	}
+
+	mCommands = std::move(commands);
+	mPoints = std::move(points);
+	mRects = std::move(rects);
+	mColors = std::move(colors);
+	mInstances = std::move(instances);
+	mTextBuffer = data.substr(offset);
+	mCounts = counts;
+}
+
+
+void RendererRecording::save(const std::string& filePath) const
+{
+	Utility<Filesystem>::get().writeFile(VirtualPath{filePath}, serialize());
+}
+
+
+void RendererRecording::load(const std::string& filePath)
+{
+	deserialize(Utility<Filesystem>::get().readFile(VirtualPath{filePath}));
+}
+
+
+RendererRecording::Command& RendererRecording::record(CommandType type)
+{
+	++mCounts[static_cast<std::size_t>(type)];
+	return mCommands.emplace_back(blankCommand(type));
+}
+
+
+std::uint32_t RendererRecording::imageIndex(const Image& image)
+{
+	const auto [iterator, inserted] = mImageIndexes.try_emplace(&image, static_cast<std::uint32_t>(mImages.size()));
+	if (inserted)
+	{
+		mImages.push_back(&image);
+	}
+	return iterator->second;
+}
+
+
+std::uint32_t RendererRecording::fontIndex(const Font& font)
+{
+	const auto [iterator, inserted] = mFontIndexes.try_emplace(&font, static_cast<std::uint32_t>(mFonts.size()));
+	if (inserted)
+	{
+		mFonts.push_back(&font);
+	}
+	return iterator->second;
+}
+
+
+std::uint32_t RendererRecording::textMeshIndex(const TextMesh& textMesh)
+{
+	const auto [iterator, inserted] = mTextMeshIndexes.try_emplace(&textMesh, static_cast<std::uint32_t>(mTextMeshes.size()));
+	if (inserted)
+	{
+		mTextMeshes.push_back(&textMesh);
+	}
+	return iterator->second;
+}
+
+
+const Image& RendererRecording::image(std::uint32_t index) const
+{
+	if (index >= mImages.size())
+	{
+		throw std::runtime_error("Recording has no image for index: " + std::to_string(index));
+	}
+	return *mImages[index];
+}
+
+
+const Font& RendererRecording::font(std::uint32_t index) const
+{
+	if (index >= mFonts.size())
+	{
+		throw std::runtime_error("Recording has no font for index: " + std::to_string(index));
+	}
+	return *mFonts[index];
+}
+
+
+const TextMesh& RendererRecording::textMesh(std::uint32_t index) const
+{
+	if (index >= mTextMeshes.size())
+	{
+		throw std::runtime_error("Recording has no text mesh for index: " + std::to_string(index));
+	}
+	return *mTextMeshes[index];
+}
+
+
+/**
+ * Stores the colors of a bulk draw, inline if one color is used for all items.
+ */
+void RendererRecording::recordColors(Command& command, std::span<const Color> colors)
+{
+	if (colors.size() == 1)
+	{
+		command.colors[0] = colors[0];
+		return;
+	}
+	command.resource = storeItems(mColors, colors);
+}
+
+
+/**
+ * Compares commands from two recordings.
+ *
+ * Item and text offsets depend on earlier commands, so commands using them are
+ * compared by content.
+ */
+bool RendererRecording::sameCommand(const Command& command, const RendererRecording& other, const Command& otherCommand) const
+{
+	const auto withoutOffsets = [](Command result) {
+		switch (result.type)
+		{
+		case CommandType::DrawText:
+		case CommandType::DrawTextMesh:
+		case CommandType::DrawImageInstances:
+			result.secondaryResource = 0;
+			break;
+		case CommandType::DrawPoints:
+		case CommandType::DrawLines:
+		case CommandType::DrawBoxes:
+		case CommandType::DrawBoxesFilled:
+			result.secondaryResource = 0;
+			result.resource = (result.resource == NoResource) ? NoResource : 0;
+			break;
+		default:
+			break;
+		}
+		return result;
+	};
+
+	return withoutOffsets(command) == withoutOffsets(otherCommand) &&
+		text(command) == other.text(otherCommand) &&
+		std::ranges::equal(points(command), other.points(otherCommand)) &&
+		std::ranges::equal(rects(command), other.rects(otherCommand)) &&
+		std::ranges::equal(colors(command), other.colors(otherCommand)) &&
+		std::ranges::equal(instances(command), other.instances(otherCommand), sameInstance);
+}
@@ -0,0 +1,204 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Renderer.h"
+#include "ImageInstance.h"
+#include "../Math/Rectangle.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Renderer that records draw calls into a command stream instead of drawing them.
+	 *
+	 * Commands are plain data, so a recording can be replayed into another Renderer,
+	 * serialized to disk, or compared against another recording. Images, fonts and
+	 * text meshes are referenced by an index into tables of the resources seen while
+	 * recording, so they must outlive replay and not change before it. The items of
+	 * bulk draws are copied, so their buffers can be reused right away.
+	 *
+	 * Recordings loaded from disk carry no resources. Commands that need an image,
+	 * font or text mesh can still be counted and compared, but not replayed.
+	 */
+	class RendererRecording : public Renderer
+	{
+	public:
+		enum class CommandType : std::uint32_t
+		{
+			DrawImage,
+			DrawSubImage,
+			DrawSubImageRotated,
+			DrawImageRotated,
+			DrawImageStretched,
+			DrawImageRepeated,
+			DrawSubImageRepeated,
+			DrawImageToImage,
+			DrawPoint,
+			DrawLine,
+			DrawBox,
+			DrawBoxFilled,
+			DrawCircle,
+			DrawCircleFilled,
+			DrawGradient,
+			DrawText,
+			ClearScreen,
+			ClipRect,
+			ClipRectClear,
+			Update,
+			SetViewport,
+			SetOrthoProjection,
+			SetRenderTarget,
+			ResetRenderTarget,
+			DrawPoints,
+			DrawLines,
+			DrawBoxes,
+			DrawBoxesFilled,
+			DrawImageInstances,
+			DrawTextMesh,
+		};
+
+		static constexpr std::size_t CommandTypeCount = static_cast<std::size_t>(CommandType::DrawTextMesh) + 1;
+		static constexpr std::uint32_t NoResource = 0xFFFFFFFF;
+
+		/**
+		 * A single recorded call.
+		 *
+		 * Field use depends on the command type. Positions are stored in
+		 * \c rect.position. \c values holds angles in degrees, scales, radii
+		 * and line widths. For DrawText and DrawTextMesh, \c secondaryResource
+		 * and \c count give the offset and length of the text in the text buffer.
+		 *
+		 * Bulk draws copy their items into item buffers. \c secondaryResource
+		 * is the offset of the first item, and \c count the number of points,
+		 * lines, boxes or instances. A single color for all items is stored in
+		 * \c colors, otherwise \c resource is the offset of per item colors.
+		 * DrawImageInstances stores its offset in \c rect.size.
+		 */
+		struct Command
+		{
+			CommandType type;
+			std::uint32_t resource;
+			std::uint32_t secondaryResource;
+			std::int32_t count;
+			Rectangle<float> rect;
+			Rectangle<float> source;
+			std::array<float, 2> values;
+			std::array<Color, 4> colors;
+
+			bool operator==(const Command& other) const = default;
+		};
+
+		RendererRecording();
+		explicit RendererRecording(Vector<int> resolution);
+		~RendererRecording() override;
+
+		void drawImage(const Image& image, Point<float> position, float scale = 1.0, Color color = Color::Normal) override;
+
+		void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color = Color::Normal) override;
+		void drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color = Color::Normal) override;
+
+		void drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color = Color::Normal, float scale = 1.0f) override;
+		void drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color = Color::Normal) override;
+
+		void drawImageRepeated(const Image& image, const Rectangle<float>& rect) override;
+		void drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source) override;
+
+		void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) override;
+
+		void drawPoint(Point<float> position, Color color = Color::White) override;
+		void drawLine(Point<float> startPosition, Point<float> endPosition, Color color = Color::White, int line_width = 1) override;
+		void drawBox(const Rectangle<float>& rect, Color color = Color::White) override;
+		void drawBoxFilled(const Rectangle<float>& rect, Color color = Color::White) override;
+		void drawCircle(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+		void drawCircleFilled(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+
+		void drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4) override;
+
+		void drawPoints(std::span<const Point<float>> positions, std::span<const Color> colors) override;
+		void drawLines(std::span<const Point<float>> endPoints, std::span<const Color> colors, int lineWidth = 1) override;
+		void drawBoxes(std::span<const Rectangle<float>> rects, std::span<const Color> colors) override;
+		void drawBoxesFilled(std::span<const Rectangle<float>> rects, std::span<const Color> colors) override;
+
+		void drawImageInstances(const Image& image, std::span<const ImageInstance> instances, Vector<float> offset = Vector{0.0f, 0.0f}) override;
+
+		void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) override;
+		void drawTextMesh(const TextMesh& textMesh, Point<float> position) override;
+
+		void clearScreen(Color color = Color::Black) override;
+
+		void update() override;
+
+		void setViewport(const Rectangle<int>& viewport) override;
+		void setOrthoProjection(const Rectangle<float>& orthoBounds) override;
+
+		void setRenderTarget(const Image& image) override;
+		void resetRenderTarget() override;
+
+		std::span<const Command> commands() const;
+		std::string_view text(const Command& command) const;
+		std::span<const Point<float>> points(const Command& command) const;
+		std::span<const Rectangle<float>> rects(const Command& command) const;
+		std::span<const Color> colors(const Command& command) const;
+		std::span<const ImageInstance> instances(const Command& command) const;
+		std::size_t count(CommandType type) const;
+		std::size_t frameCount() const;
+		void clear();
+		void clearResources();
+		void swapCommands(RendererRecording& other);
+
+		void replay(Renderer& renderer) const;
+		std::vector<std::size_t> differences(const RendererRecording& other) const;
+
+		std::string serialize() const;
+		void deserialize(std::string_view data);
+		void save(const std::string& filePath) const;
+		void load(const std::string& filePath);
+
+	protected:
+		void onClipRect(const Rectangle<float>& rect) override;
+		void onClipRectClear() override;
+
+	private:
+		Command& record(CommandType type);
+		std::uint32_t imageIndex(const Image& image);
+		std::uint32_t fontIndex(const Font& font);
+		std::uint32_t textMeshIndex(const TextMesh& textMesh);
+		const Image& image(std::uint32_t index) const;
+		const Font& font(std::uint32_t index) const;
+		const TextMesh& textMesh(std::uint32_t index) const;
+		void recordColors(Command& command, std::span<const Color> colors);
+		bool sameCommand(const Command& command, const RendererRecording& other, const Command& otherCommand) const;
+
+		std::vector<Command> mCommands{};
+		std::string mTextBuffer{};
+		std::vector<Point<float>> mPoints{};
+		std::vector<Rectangle<float>> mRects{};
+		std::vector<Color> mColors{};
+		std::vector<ImageInstance> mInstances{};
+		std::array<std::size_t, CommandTypeCount> mCounts{};
+
+		std::vector<const Image*> mImages{};
+		std::vector<const Font*> mFonts{};
+		std::vector<const TextMesh*> mTextMeshes{};
+		std::unordered_map<const Image*, std::uint32_t> mImageIndexes{};
+		std::unordered_map<const Font*, std::uint32_t> mFontIndexes{};
+		std::unordered_map<const TextMesh*, std::uint32_t> mTextMeshIndexes{};
+	};
+}
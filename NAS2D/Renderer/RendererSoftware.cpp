@@ -0,0 +1,669 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "RendererSoftware.h"
+
+#include "PixelBlend.h"
+#include "../Resource/Font.h"
+#include "../Resource/Image.h"
+#include "../Math/Angle.h"
+#include "../Math/Trig.h"
+#include "../ThreadPool.h"
+#include "../Utility.h"
+#include "../StringFrom.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	// Draws smaller than this are not worth handing to other threads
+	constexpr std::size_t ParallelPixelThreshold = 32 * 1024;
+
+
+	Rectangle<int> intersection(const Rectangle<int>& a, const Rectangle<int>& b)
+	{
+		const auto start = Point{std::max(a.position.x, b.position.x), std::max(a.position.y, b.position.y)};
+		const auto aEnd = a.endPoint();
+		const auto bEnd = b.endPoint();
+		const auto end = Point{std::max(start.x, std::min(aEnd.x, bEnd.x)), std::max(start.y, std::min(aEnd.y, bEnd.y))};
+		return Rectangle<int>::Create(start, end);
+	}
+
+
+	/**
+	 * Index of the first pixel whose center is at or past a coordinate.
+	 */
+	int pixelIndex(float coordinate)
+	{
+		return static_cast<int>(std::ceil(coordinate - 0.5f));
+	}
+
+
+	int wrap(int value, int start, int length)
+	{
+		const auto offset = (value - start) % length;
+		return start + ((offset < 0) ? offset + length : offset);
+	}
+
+
+	std::uint8_t mix(std::uint8_t a, std::uint8_t b, float fraction)
+	{
+		return static_cast<std::uint8_t>(std::lround(a + (b - a) * fraction));
+	}
+
+
+	Color mix(Color a, Color b, float fraction)
+	{
+		return {mix(a.red, b.red, fraction), mix(a.green, b.green, fraction), mix(a.blue, b.blue, fraction), mix(a.alpha, b.alpha, fraction)};
+	}
+
+
+	/**
+	 * Narrows [begin, end) to the steps where 0 <= start + step * i < 1.
+	 */
+	void limitToUnitRange(float start, float step, float& begin, float& end)
+	{
+		if (step == 0.0f)
+		{
+			if (start < 0.0f || start >= 1.0f) { end = begin; }
+			return;
+		}
+
+		auto lower = -start / step;
+		auto upper = (1.0f - start) / step;
+		if (step < 0.0f) { std::swap(lower, upper); }
+		begin = std::max(begin, lower);
+		end = std::min(end, upper);
+	}
+}
+
+
+RendererSoftware::RendererSoftware()
+{
+	RendererSoftware::onResize(mResolution);
+}
+
+
+RendererSoftware::RendererSoftware(Vector<int> resolution)
+{
+	RendererSoftware::onResize(resolution);
+}
+
+
+RendererSoftware::~RendererSoftware() = default;
+
+
+void RendererSoftware::drawImage(const Image& image, Point<float> position, float scale, Color color)
+{
+	const auto imageSize = image.size().to<float>();
+	if (isCulled({position, imageSize * scale})) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, toScreen(Rectangle{position, imageSize * scale}), {{0, 0}, imageSize}, color);
+}
+
+
+void RendererSoftware::drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color)
+{
+	if (isCulled({raster, subImageRect.size})) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, toScreen(Rectangle{raster, subImageRect.size}), subImageRect, color);
+}
+
+
+void RendererSoftware::drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color)
+{
+	const auto halfSize = subImageRect.size / 2;
+	if (isCulled(raster + halfSize, std::sqrt(halfSize.lengthSquared()))) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, rotatedQuad(raster + halfSize, halfSize, angle), subImageRect, color);
+}
+
+
+void RendererSoftware::drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color, float scale)
+{
+	const auto imageSize = image.size().to<float>();
+	const auto halfSize = imageSize / 2;
+	if (isCulled(position + halfSize, std::sqrt(halfSize.lengthSquared()) * std::abs(scale))) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, rotatedQuad(position + halfSize, halfSize * scale, angle), {{0, 0}, imageSize}, color);
+}
+
+
+void RendererSoftware::drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color)
+{
+	if (isCulled(rect)) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, toScreen(rect), {{0, 0}, image.size().to<float>()}, color);
+}
+
+
+void RendererSoftware::drawImageRepeated(const Image& image, const Rectangle<float>& rect)
+{
+	if (isCulled(rect)) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, toScreen(rect), {{0, 0}, rect.size}, Color::Normal, Rectangle{Point{0, 0}, image.size()});
+}
+
+
+void RendererSoftware::drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source)
+{
+	if (isCulled(destination)) { return; }
+
+	drawTexture({image.rgbaPixels(), image.size()}, toScreen(destination), {source.position, destination.size}, Color::Normal, source.to<int>());
+}
+
+
+void RendererSoftware::drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint)
+{
+	const auto dstPointInt = dstPoint.to<int>();
+	const auto destinationSize = destination.size();
+	const auto area = intersection(Rectangle{dstPointInt, source.size()}, Rectangle{Point{0, 0}, destinationSize});
+	if (area.empty()) { return; }
+
+	const auto sourcePixels = source.rgbaPixels();
+	const auto destinationPixels = destination.renderTargetPixels();
+	const auto width = static_cast<std::size_t>(area.size.x);
+	for (int y = area.position.y; y < area.endPoint().y; ++y)
+	{
+		const auto sourceOffset = (y - dstPointInt.y) * source.size().x + (area.position.x - dstPointInt.x);
+		const auto destinationOffset = y * destinationSize.x + area.position.x;
+		blendRow(destinationPixels.subspan(static_cast<std::size_t>(destinationOffset), width), sourcePixels.subspan(static_cast<std::size_t>(sourceOffset), width), Color::Normal);
+	}
+}
+
+
+void RendererSoftware::drawPoint(Point<float> position, Color color)
+{
+	if (isCulled({position, {1, 1}})) { return; }
+
+	const auto screenPosition = toScreen(position);
+	const auto pixelPosition = Point{std::floor(screenPosition.x), std::floor(screenPosition.y)};
+	drawQuad(Quad{pixelPosition, {1, 0}, {0, 1}}, color);
+}
+
+
+void RendererSoftware::drawLine(Point<float> startPosition, Point<float> endPosition, Color color, int lineWidth)
+{
+	if (isCulled(lineBounds(startPosition, endPosition, lineWidth))) { return; }
+
+	const auto offset = Vector<float>{0.5, 0.5};
+	const auto start = toScreen(startPosition + offset);
+	const auto direction = toScreen(endPosition + offset) - start;
+	const auto length = std::sqrt(direction.lengthSquared());
+	if (length == 0.0f) { return; }
+
+	const auto normal = Vector{-direction.y, direction.x} * (static_cast<float>(std::max(lineWidth, 1)) / length);
+	drawQuad(Quad{start - normal / 2, direction, normal}, color);
+}
+
+
+void RendererSoftware::drawBox(const Rectangle<float>& rect, Color color)
+{
+	if (rect.empty() || isCulled(rect))
+	{
+		return;
+	}
+
+	// Outline is one pixel wide regardless of projection, as with OpenGL lines
+	const auto start = toScreen(rect.position);
+	const auto end = toScreen(rect.endPoint());
+	const auto p1 = Point{std::round(start.x), std::round(start.y)};
+	const auto size = Vector{std::round(end.x) - p1.x, std::round(end.y) - p1.y};
+	if (size.x <= 0 || size.y <= 0) { return; }
+
+	drawQuad(Quad{p1, {size.x, 0}, {0, 1}}, color);
+	if (size.y > 1)
+	{
+		drawQuad(Quad{{p1.x, p1.y + size.y - 1}, {size.x, 0}, {0, 1}}, color);
+	}
+	if (size.y > 2)
+	{
+		drawQuad(Quad{{p1.x, p1.y + 1}, {1, 0}, {0, size.y - 2}}, color);
+		if (size.x > 1)
+		{
+			drawQuad(Quad{{p1.x + size.x - 1, p1.y + 1}, {1, 0}, {0, size.y - 2}}, color);
+		}
+	}
+}
+
+
+void RendererSoftware::drawBoxFilled(const Rectangle<float>& rect, Color color)
+{
+	if (rect.empty() || isCulled(rect))
+	{
+		return;
+	}
+
+	drawQuad(toScreen(rect), color);
+}
+
+
+void RendererSoftware::drawCircle(Point<float> position, float radius, Color color, int numSegments, Vector<float> scale)
+{
+	if (isCulled(position, radius * std::max(std::abs(scale.x), std::abs(scale.y)))) { return; }
+
+	const auto theta = Angle::degrees(360) / static_cast<float>(numSegments);
+	const auto cosTheta = std::cos(theta.radians());
+	const auto sinTheta = std::sin(theta.radians());
+
+	auto offset = Vector<float>{radius, 0};
+	const auto firstPoint = position + offset.skewBy(scale);
+	auto previousPoint = firstPoint;
+	for (int i = 1; i < numSegments; ++i)
+	{
+		offset = {cosTheta * offset.x - sinTheta * offset.y, sinTheta * offset.x + cosTheta * offset.y};
+
+		const auto point = position + offset.skewBy(scale);
+		drawLine(previousPoint, point, color);
+		previousPoint = point;
+	}
+	drawLine(previousPoint, firstPoint, color);
+}
+
+
+void RendererSoftware::drawCircleFilled(Point<float> position, float radius, Color color, int numSegments, Vector<float> scale)
+{
+	if (numSegments < 3) { return; }
+	if (isCulled(position, radius * std::max(std::abs(scale.x), std::abs(scale.y)))) { return; }
+
+	std::vector<Point<float>> points;
+	points.reserve(static_cast<std::size_t>(numSegments));
+	const auto axes = scale * radius;
+	for (int i = 0; i < numSegments; ++i)
+	{
+		const auto direction = getDirectionVector(Angle::degrees(360.0f * static_cast<float>(i) / static_cast<float>(numSegments)));
+		points.push_back(toScreen(position + direction.skewBy(axes)));
+	}
+
+	drawConvexPolygon(points, color);
+}
+
+
+void RendererSoftware::drawGradient(const Rectangle<float>& rect, Color c1, Color c2, Color c3, Color c4)
+{
+	if (isCulled(rect)) { return; }
+
+	drawQuad(toScreen(rect), [c1, c2, c3, c4](float s, float t) {
+		return mix(mix(c1, c4, s), mix(c2, c3, s), t);
+	});
+}
+
+
+void RendererSoftware::drawText(const Font& font, std::string_view text, Point<float> position, Color color)
+{
+	if (text.empty() || isCulled(textBounds(font, font.size(text), position))) { return; }
+
+	const auto& gml = font.metrics();
+	const auto& glyphMap = font.glyphMap();
+	if (gml.empty() || glyphMap.empty()) { return; }
+
+	const auto glyphCellSize = font.glyphCellSize();
+	const auto glyphMapTexture = Texture{glyphMap, glyphCellSize * 16};
+	const auto glyphMapSize = glyphMapTexture.size.to<float>();
+
+	Vector<int> offset{0, 0};
+	for (auto character : text)
+	{
+		if (character == '\n')
+		{
+			offset.y += font.height();
+			offset.x = 0;
+			continue;
+		}
+
+		const auto& gm = gml[std::clamp<std::size_t>(static_cast<uint8_t>(character), 0, 255)];
+
+		const auto adjustX = (gm.minX < 0) ? gm.minX : 0;
+		const auto glyphPosition = Point{position.x + static_cast<float>(offset.x + adjustX), position.y + static_cast<float>(offset.y)};
+		drawTexture(glyphMapTexture, toScreen(Rectangle{glyphPosition, glyphCellSize.to<float>()}), gm.uvRect.skewBy(glyphMapSize), color);
+		offset.x += gm.advance;
+	}
+}
+
+
+void RendererSoftware::clearScreen(Color color)
+{
+	forEachRow(mClipRect, [color](int, std::span<Color> row, std::vector<Color>&) {
+		std::fill(row.begin(), row.end(), color);
+	});
+}
+
+
+/**
+ * Clip rects are in drawing coordinates, so are mapped to pixels the same as
+ * everything drawn.
+ */
+void RendererSoftware::onClipRect(const Rectangle<float>& rect)
+{
+	const auto start = toScreen(rect.position);
+	const auto end = toScreen(rect.endPoint());
+	const auto pixelRect = Rectangle<float>::Create({std::min(start.x, end.x), std::min(start.y, end.y)}, {std::max(start.x, end.x), std::max(start.y, end.y)});
+	mClipRect = intersection(pixelRect.to<int>(), {{0, 0}, mTargetSize});
+}
+
+
+void RendererSoftware::onClipRectClear()
+{
+	mClipRect = {{0, 0}, mTargetSize};
+}
+
+
+/**
+ * Nothing to present. The finished frame stays in the pixel buffer.
+ */
+void RendererSoftware::update()
+{
+}
+
+
+void RendererSoftware::setViewport(const Rectangle<int>& viewport)
+{
+	mViewport = viewport;
+	if (clipDepth() > 0) { applyClipStack(); }
+}
+
+
+void RendererSoftware::setOrthoProjection(const Rectangle<float>& orthoBounds)
+{
+	mOrthoBounds = orthoBounds;
+	cullArea(orthoBounds);
+	if (clipDepth() > 0) { applyClipStack(); }
+}
+
+
+/**
+ * Draws into an image until resetRenderTarget is called.
+ *
+ * The viewport and projection are set to the image's pixels and clipping is
+ * cleared. The frame's viewport and projection are restored afterwards.
+ */
+void RendererSoftware::setRenderTarget(const Image& image)
+{
+	if (!mRenderingToImage)
+	{
+		mScreenViewport = mViewport;
+		mScreenOrthoBounds = mOrthoBounds;
+	}
+
+	mRenderingToImage = true;
+	mTargetPixels = image.renderTargetPixels();
+	mTargetSize = image.size();
+
+	const auto imageRect = Rectangle{{0, 0}, mTargetSize};
+	setViewport(imageRect);
+	setOrthoProjection(imageRect.to<float>());
+	renderTargetClip(true);
+	applyClipStack();
+}
+
+
+void RendererSoftware::resetRenderTarget()
+{
+	if (!mRenderingToImage) { return; }
+
+	mRenderingToImage = false;
+	mTargetPixels = mPixels;
+	mTargetSize = mFrameSize;
+
+	setViewport(mScreenViewport);
+	setOrthoProjection(mScreenOrthoBounds);
+	renderTargetClip(false);
+	applyClipStack();
+}
+
+
+Vector<int> RendererSoftware::frameSize() const
+{
+	return mFrameSize;
+}
+
+
+/**
+ * Rendered pixels in RGBA32, in rows from the top left.
+ */
+std::span<const Color> RendererSoftware::pixels() const
+{
+	return mPixels;
+}
+
+
+Color RendererSoftware::pixel(Point<int> position) const
+{
+	if (!Rectangle{{0, 0}, mFrameSize}.contains(position))
+	{
+		throw std::runtime_error("Pixel coordinates out of bounds: " + stringFrom(position));
+	}
+	return mPixels[static_cast<std::size_t>(position.y * mFrameSize.x + position.x)];
+}
+
+
+/**
+ * Resizes the pixel buffer, clearing it, and resets the viewport, projection and clipping.
+ *
+ * Drawing returns to the frame if it was going to a render target.
+ */
+void RendererSoftware::onResize(Vector<int> newSize)
+{
+	mFrameSize = newSize;
+	mPixels.assign(static_cast<std::size_t>(newSize.x * newSize.y), Color::Black);
+	mRenderingToImage = false;
+	mTargetPixels = mPixels;
+	mTargetSize = newSize;
+
+	const auto viewportRect = Rectangle{{0, 0}, newSize};
+	setViewport(viewportRect);
+	setOrthoProjection(viewportRect.to<float>());
+	applyClipStack();
+	setResolution(newSize);
+}
+
+
+Point<float> RendererSoftware::toScreen(Point<float> point) const
+{
+	const auto scale = mViewport.size.to<float>().skewInverseBy(mOrthoBounds.size);
+	return mViewport.position.to<float>() + (point - mOrthoBounds.position).skewBy(scale);
+}
+
+
+RendererSoftware::Quad RendererSoftware::toScreen(const Rectangle<float>& rect) const
+{
+	const auto start = toScreen(rect.position);
+	const auto end = toScreen(rect.endPoint());
+	return {start, {end.x - start.x, 0}, {0, end.y - start.y}};
+}
+
+
+RendererSoftware::Quad RendererSoftware::rotatedQuad(Point<float> center, Vector<float> halfSize, Angle angle) const
+{
+	const auto radians = angle.radians();
+	const auto sine = std::sin(radians);
+	const auto cosine = std::cos(radians);
+	const auto rotate = [sine, cosine](Vector<float> offset) {
+		return Vector{offset.x * cosine - offset.y * sine, offset.x * sine + offset.y * cosine};
+	};
+
+	const auto screenScale = mViewport.size.to<float>().skewInverseBy(mOrthoBounds.size);
+	return {
+		toScreen(center + rotate({-halfSize.x, -halfSize.y})),
+		rotate({halfSize.x * 2, 0}).skewBy(screenScale),
+		rotate({0, halfSize.y * 2}).skewBy(screenScale),
+	};
+}
+
+
+/**
+ * Fills the pixels whose centers fall within a quad.
+ *
+ * \param shader	Either a Color to fill with, or a function returning the color at
+ *					quad coordinates (s, t), both in the range [0, 1). Shaders are
+ *					called from multiple threads.
+ * \param modulate	Color the shader results are multiplied by.
+ */
+template <typename Shader>
+void RendererSoftware::drawQuad(const Quad& quad, Shader shader, Color modulate)
+{
+	const auto& [origin, xAxis, yAxis] = quad;
+	const auto determinant = xAxis.x * yAxis.y - xAxis.y * yAxis.x;
+	if (determinant == 0.0f) { return; }
+
+	const std::array<Point<float>, 4> corners{origin, origin + xAxis, origin + yAxis, origin + xAxis + yAxis};
+	const auto [minX, maxX] = std::minmax({corners[0].x, corners[1].x, corners[2].x, corners[3].x});
+	const auto [minY, maxY] = std::minmax({corners[0].y, corners[1].y, corners[2].y, corners[3].y});
+	const auto bounds = intersection(Rectangle<int>::Create({pixelIndex(minX), pixelIndex(minY)}, {pixelIndex(maxX), pixelIndex(maxY)}), mClipRect);
+	if (bounds.empty()) { return; }
+
+	// Inverse of the matrix with the quad axes as columns
+	const auto sStep = Vector{yAxis.y, -yAxis.x} / determinant;
+	const auto tStep = Vector{-xAxis.y, xAxis.x} / determinant;
+	const auto width = static_cast<float>(bounds.size.x);
+
+	forEachRow(bounds, [&](int y, std::span<Color> row, std::vector<Color>& scratch) {
+		const auto offset = Point{static_cast<float>(bounds.position.x), static_cast<float>(y)} + Vector{0.5f, 0.5f} - origin;
+		const auto s = sStep.dotProduct(offset);
+		const auto t = tStep.dotProduct(offset);
+
+		auto begin = 0.0f;
+		auto end = width;
+		limitToUnitRange(s, sStep.x, begin, end);
+		limitToUnitRange(t, tStep.x, begin, end);
+		const auto first = static_cast<std::size_t>(std::clamp(std::ceil(begin), 0.0f, width));
+		const auto last = static_cast<std::size_t>(std::clamp(std::ceil(end), 0.0f, width));
+		if (first >= last) { return; }
+
+		const auto span = row.subspan(first, last - first);
+		if constexpr (std::is_same_v<Shader, Color>)
+		{
+			blendRow(span, shader);
+		}
+		else
+		{
+			for (auto i = first; i < last; ++i)
+			{
+				const auto step = static_cast<float>(i);
+				scratch[i - first] = shader(s + sStep.x * step, t + tStep.x * step);
+			}
+			blendRow(span, {scratch.data(), span.size()}, modulate);
+		}
+	});
+}
+
+
+/**
+ * Fills the pixels whose centers fall within a convex polygon given in screen pixels.
+ */
+void RendererSoftware::drawConvexPolygon(std::span<const Point<float>> points, Color color)
+{
+	if (points.size() < 3) { return; }
+
+	auto minPoint = points.front();
+	auto maxPoint = points.front();
+	for (const auto& point : points)
+	{
+		minPoint = {std::min(minPoint.x, point.x), std::min(minPoint.y, point.y)};
+		maxPoint = {std::max(maxPoint.x, point.x), std::max(maxPoint.y, point.y)};
+	}
+	const auto bounds = intersection(Rectangle<int>::Create({pixelIndex(minPoint.x), pixelIndex(minPoint.y)}, {pixelIndex(maxPoint.x), pixelIndex(maxPoint.y)}), mClipRect);
+	if (bounds.empty()) { return; }
+
+	forEachRow(bounds, [&](int y, std::span<Color> row, std::vector<Color>&) {
+		const auto centerY = static_cast<float>(y) + 0.5f;
+
+		// A convex polygon crosses each row in a single span
+		auto spanStart = std::numeric_limits<float>::max();
+		auto spanEnd = std::numeric_limits<float>::lowest();
+		auto previous = points.back();
+		for (const auto& point : points)
+		{
+			const auto [upper, lower] = std::minmax(previous, point, [](const auto& a, const auto& b) { return a.y < b.y; });
+			if (upper.y <= centerY && centerY < lower.y)
+			{
+				const auto x = upper.x + (lower.x - upper.x) * (centerY - upper.y) / (lower.y - upper.y);
+				spanStart = std::min(spanStart, x);
+				spanEnd = std::max(spanEnd, x);
+			}
+			previous = point;
+		}
+
+		const auto first = std::clamp(pixelIndex(spanStart), bounds.position.x, bounds.endPoint().x);
+		const auto last = std::clamp(pixelIndex(spanEnd), bounds.position.x, bounds.endPoint().x);
+		if (first >= last) { return; }
+
+		blendRow(row.subspan(static_cast<std::size_t>(first - bounds.position.x), static_cast<std::size_t>(last - first)), color);
+	});
+}
+
+
+/**
+ * Draws a textured quad, point sampling the texture.
+ *
+ * \param source	Texel area mapped onto the quad.
+ * \param wrapArea	Texel area that sampling repeats within. When empty, sampling is
+ *					clamped to the texture edges instead.
+ */
+void RendererSoftware::drawTexture(const Texture& texture, const Quad& quad, const Rectangle<float>& source, Color color, std::optional<Rectangle<int>> wrapArea)
+{
+	if (texture.size.x <= 0 || texture.size.y <= 0) { return; }
+	if (wrapArea && (wrapArea->size.x <= 0 || wrapArea->size.y <= 0)) { return; }
+
+	drawQuad(quad, [&texture, &source, wrapArea](float s, float t) {
+		auto x = static_cast<int>(std::floor(source.position.x + s * source.size.x));
+		auto y = static_cast<int>(std::floor(source.position.y + t * source.size.y));
+		if (wrapArea)
+		{
+			x = wrap(x, wrapArea->position.x, wrapArea->size.x);
+			y = wrap(y, wrapArea->position.y, wrapArea->size.y);
+		}
+		x = std::clamp(x, 0, texture.size.x - 1);
+		y = std::clamp(y, 0, texture.size.y - 1);
+		return texture.pixels[static_cast<std::size_t>(y * texture.size.x + x)];
+	}, color);
+}
+
+
+/**
+ * Runs a function over each row of an area of the pixel buffer.
+ *
+ * Large areas have their rows split across the shared ThreadPool. Each chunk of
+ * rows gets its own scratch buffer, as wide as the area.
+ */
+void RendererSoftware::forEachRow(const Rectangle<int>& bounds, const RowFunction& drawRow)
+{
+	if (bounds.empty()) { return; }
+
+	const auto width = static_cast<std::size_t>(bounds.size.x);
+	const auto rowCount = static_cast<std::size_t>(bounds.size.y);
+	const auto drawRows = [this, &bounds, &drawRow, width](std::size_t begin, std::size_t end) {
+		std::vector<Color> scratch(width);
+		for (auto i = begin; i < end; ++i)
+		{
+			const auto y = bounds.position.y + static_cast<int>(i);
+			const auto rowStart = static_cast<std::size_t>(y * mTargetSize.x + bounds.position.x);
+			drawRow(y, mTargetPixels.subspan(rowStart, width), scratch);
+		}
+	};
+
+	if (width * rowCount < ParallelPixelThreshold)
+	{
+		drawRows(0, rowCount);
+	}
+	else
+	{
+		Utility<ThreadPool>::get().parallelFor(rowCount, drawRows);
+	}
+}
@@ -0,0 +1,128 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Renderer.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Renderer that rasterizes on the CPU into an RGBA32 pixel buffer.
+	 *
+	 * Needs no window or graphics context, so it suits headless rendering and
+	 * checking drawing code in tests. Images and glyphs are point sampled. Blending
+	 * matches the OpenGL renderer and uses the vectorized kernels from PixelBlend.
+	 * Draws covering many pixels split their rows across the shared ThreadPool.
+	 *
+	 * Render targets are drawn into through their RGBA32 surface pixels, so an
+	 * Image rendered into this way has its pixels updated but not its texture.
+	 */
+	class RendererSoftware : public Renderer
+	{
+	public:
+		RendererSoftware();
+		explicit RendererSoftware(Vector<int> resolution);
+		~RendererSoftware() override;
+
+		void drawImage(const Image& image, Point<float> position, float scale = 1.0, Color color = Color::Normal) override;
+
+		void drawSubImage(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Color color = Color::Normal) override;
+		void drawSubImageRotated(const Image& image, Point<float> raster, const Rectangle<float>& subImageRect, Angle angle, Color color = Color::Normal) override;
+
+		void drawImageRotated(const Image& image, Point<float> position, Angle angle, Color color = Color::Normal, float scale = 1.0f) override;
+		void drawImageStretched(const Image& image, const Rectangle<float>& rect, Color color = Color::Normal) override;
+
+		void drawImageRepeated(const Image& image, const Rectangle<float>& rect) override;
+		void drawSubImageRepeated(const Image& image, const Rectangle<float>& destination, const Rectangle<float>& source) override;
+
+		void drawImageToImage(const Image& source, const Image& destination, Point<float> dstPoint) override;
+
+		void drawPoint(Point<float> position, Color color = Color::White) override;
+		void drawLine(Point<float> startPosition, Point<float> endPosition, Color color = Color::White, int line_width = 1) override;
+		void drawBox(const Rectangle<float>& rect, Color color = Color::White) override;
+		void drawBoxFilled(const Rectangle<float>& rect, Color color = Color::White) override;
+		void drawCircle(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+		void drawCircleFilled(Point<float> position, float radius, Color color, int num_segments = 10, Vector<float> scale = Vector{1.0f, 1.0f}) override;
+
+		void drawGradient(const Rectangle<float>& rect, Color colorUpperLeft, Color colorLowerLeft, Color colorLowerRight, Color colorUpperRight) override;
+
+		void drawText(const Font& font, std::string_view text, Point<float> position, Color color = Color::White) override;
+
+		void clearScreen(Color color = Color::Black) override;
+
+		void update() override;
+
+		void setViewport(const Rectangle<int>& viewport) override;
+		void setOrthoProjection(const Rectangle<float>& orthoBounds) override;
+
+		void setRenderTarget(const Image& image) override;
+		void resetRenderTarget() override;
+
+		Vector<int> frameSize() const;
+		std::span<const Color> pixels() const;
+		Color pixel(Point<int> position) const;
+
+	protected:
+		void onResize(Vector<int> newSize) override;
+		void onClipRect(const Rectangle<float>& rect) override;
+		void onClipRectClear() override;
+
+	private:
+		/**
+		 * Parallelogram in screen pixels, spanned by two axes from an origin.
+		 */
+		struct Quad
+		{
+			Point<float> origin;
+			Vector<float> xAxis;
+			Vector<float> yAxis;
+		};
+
+		struct Texture
+		{
+			std::span<const Color> pixels;
+			Vector<int> size;
+		};
+
+		using RowFunction = std::function<void(int y, std::span<Color> row, std::vector<Color>& scratch)>;
+
+		Point<float> toScreen(Point<float> point) const;
+		Quad toScreen(const Rectangle<float>& rect) const;
+		Quad rotatedQuad(Point<float> center, Vector<float> halfSize, Angle angle) const;
+
+		template <typename Shader>
+		void drawQuad(const Quad& quad, Shader shader, Color modulate = Color::Normal);
+		void drawConvexPolygon(std::span<const Point<float>> points, Color color);
+		void drawTexture(const Texture& texture, const Quad& quad, const Rectangle<float>& source, Color color, std::optional<Rectangle<int>> wrapArea = std::nullopt);
+		void forEachRow(const Rectangle<int>& bounds, const RowFunction& drawRow);
+
+		Vector<int> mFrameSize{};
+		std::vector<Color> mPixels{};
+		Rectangle<int> mClipRect{};
+		Rectangle<int> mViewport{};
+		Rectangle<float> mOrthoBounds{};
+
+		// Pixels being drawn into, either the frame or a render target image
+		std::span<Color> mTargetPixels{};
+		Vector<int> mTargetSize{};
+		bool mRenderingToImage{false};
+		Rectangle<int> mScreenViewport{};
+		Rectangle<float> mScreenOrthoBounds{};
+	};
+}
@@ -0,0 +1,197 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "StreamingVertexBuffer.h"
+#include "GLStateCache.h"
+#include "../Utility.h"
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr std::size_t WriteAlignment = 16;
+
+	constexpr std::size_t alignUp(std::size_t value, std::size_t alignment = WriteAlignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+
+	bool persistentMappingSupported()
+	{
+		return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+	}
+
+
+	void waitForFence(void* fence)
+	{
+		if (!fence) { return; }
+
+		auto sync = static_cast<GLsync>(fence);
+		while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+		{
+		}
+		glDeleteSync(sync);
+	}
+}
+
+
+/**
+ * \param capacity	Initial size of the buffer in bytes. Grows as needed.
+ */
+StreamingVertexBuffer::StreamingVertexBuffer(std::size_t capacity)
+{
+	allocate(alignUp(capacity));
+}
+
+
+StreamingVertexBuffer::~StreamingVertexBuffer()
+{
+	release();
+}
+
+
+bool StreamingVertexBuffer::isPersistentlyMapped() const
+{
+	return mMappedData != nullptr;
+}
+
+
+std::size_t StreamingVertexBuffer::capacity() const
+{
+	return mCapacity;
+}
+
+
+/**
+ * Copies data into the buffer with a single bulk upload.
+ *
+ * The buffer is left bound to GL_ARRAY_BUFFER.
+ *
+ * \return	Byte offset of the written data within the buffer.
+ */
+std::size_t StreamingVertexBuffer::write(std::span<const std::byte> data)
+{
+	const auto size = alignUp(data.size());
+	if (size > mCapacity / SegmentCount)
+	{
+		release();
+		allocate(std::max(size * SegmentCount, mCapacity * 2));
+	}
+
+	Utility<GLStateCache>::get().bindBuffer(GL_ARRAY_BUFFER, mBufferId);
+
+	if (mMappedData)
+	{
+		// Writes never straddle segments. A segment's fence is only created once
+		// writing has moved past it, after the draws reading it were issued.
+		const auto segmentSize = mCapacity / SegmentCount;
+		const auto segmentEnd = (mOffset / segmentSize + 1) * segmentSize;
+		if (mOffset + size > segmentEnd)
+		{
+			mOffset = segmentEnd;
+		}
+	}
+
+	if (mOffset + size > mCapacity)
+	{
+		mOffset = 0;
+		if (!mMappedData)
+		{
+			glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mCapacity), nullptr, GL_STREAM_DRAW);
+		}
+	}
+
+	const auto offset = mOffset;
+	if (mMappedData)
+	{
+		enterSegment(offset / (mCapacity / SegmentCount));
+		std::memcpy(mMappedData + offset, data.data(), data.size());
+	}
+	else
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(data.size()), data.data());
+	}
+
+	mOffset += size;
+	return offset;
+}
+
+
+void StreamingVertexBuffer::allocate(std::size_t capacity)
+{
+	// Segment boundaries stay aligned for writes
+	mCapacity = alignUp(std::max(capacity, WriteAlignment * SegmentCount), WriteAlignment * SegmentCount);
+	mOffset = 0;
+	mCurrentSegment = 0;
+
+	glGenBuffers(1, &mBufferId);
+	Utility<GLStateCache>::get().bindBuffer(GL_ARRAY_BUFFER, mBufferId);
+
+	if (persistentMappingSupported())
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mCapacity), nullptr, flags);
+		mMappedData = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(mCapacity), flags));
+	}
+
+	if (!mMappedData)
+	{
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mCapacity), nullptr, GL_STREAM_DRAW);
+	}
+}
+
+
+void StreamingVertexBuffer::release()
+{
+	for (auto& fence : mSegmentFences)
+	{
+		waitForFence(fence);
+		fence = nullptr;
+	}
+
+	if (mBufferId != 0)
+	{
+		if (mMappedData)
+		{
+			Utility<GLStateCache>::get().bindBuffer(GL_ARRAY_BUFFER, mBufferId);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			mMappedData = nullptr;
+		}
+		Utility<GLStateCache>::get().deleteBuffer(mBufferId);
+		mBufferId = 0;
+	}
+}
+
+
+/**
+ * Fences the current segment as writing moves past it, and waits for the GPU to
+ * finish reading the next segment before it is written to again.
+ */
+void StreamingVertexBuffer::enterSegment(std::size_t segment)
+{
+	if (segment == mCurrentSegment) { return; }
+
+	mSegmentFences[mCurrentSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mCurrentSegment = segment;
+	waitForFence(mSegmentFences[segment]);
+	mSegmentFences[segment] = nullptr;
+}
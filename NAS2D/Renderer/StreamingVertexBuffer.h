@@ -0,0 +1,57 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+
+namespace NAS2D
+{
+	/**
+	 * Ring buffered OpenGL vertex buffer for per-frame geometry.
+	 *
+	 * Data is appended to a single GL_ARRAY_BUFFER. When persistent mapping is
+	 * available (GL 4.4 or ARB_buffer_storage), the buffer stays mapped and is split
+	 * into segments guarded by fences, so the CPU never writes over data the GPU has
+	 * yet to read. Otherwise the buffer is orphaned each time it wraps around, which
+	 * lets the driver hand out fresh storage without stalling.
+	 *
+	 * \note	Requires a current OpenGL context for construction and destruction.
+	 */
+	class StreamingVertexBuffer
+	{
+	public:
+		explicit StreamingVertexBuffer(std::size_t capacity);
+		StreamingVertexBuffer(const StreamingVertexBuffer&) = delete;
+		StreamingVertexBuffer& operator=(const StreamingVertexBuffer&) = delete;
+		~StreamingVertexBuffer();
+
+		bool isPersistentlyMapped() const;
+		std::size_t capacity() const;
+
+		std::size_t write(std::span<const std::byte> data);
+
+	private:
+		static constexpr std::size_t SegmentCount = 3;
+
+		void allocate(std::size_t capacity);
+		void release();
+		void enterSegment(std::size_t segment);
+
+		unsigned int mBufferId{0u};
+		std::size_t mCapacity{0u};
+		std::size_t mOffset{0u};
+		std::byte* mMappedData{nullptr};
+		std::size_t mCurrentSegment{0u};
+		std::array<void*, SegmentCount> mSegmentFences{};
+	};
+}
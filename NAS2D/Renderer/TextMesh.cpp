@@ -0,0 +1,123 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "TextMesh.h"
+
+#include "../Resource/Font.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+using namespace NAS2D;
+
+
+/**
+ * Lays out a string as textured quads, two triangles per glyph.
+ *
+ * \param vertices	Vertices are appended to the end of this.
+ * \param position	Top left of the text.
+ */
+void TextMesh::appendVertices(std::vector<Vertex>& vertices, const Font& font, std::string_view text, Point<float> position, Color color)
+{
+	const auto& gml = font.metrics();
+	if (gml.empty() || text.empty()) { return; }
+
+	const auto glyphCellSize = font.glyphCellSize().to<float>();
+	const auto lineHeight = font.height();
+	vertices.reserve(vertices.size() + text.size() * 6);
+
+	Vector<int> offset{0, 0};
+	for (auto character : text)
+	{
+		if (character == '\n')
+		{
+			offset.y += lineHeight;
+			offset.x = 0;
+			continue;
+		}
+
+		const auto& gm = gml[std::clamp<std::size_t>(static_cast<uint8_t>(character), 0, 255)];
+
+		const auto adjustX = (gm.minX < 0) ? gm.minX : 0;
+		const auto glyphPosition = Point{position.x + static_cast<float>(offset.x + adjustX), position.y + static_cast<float>(offset.y)};
+		const auto quad = rectToQuad({glyphPosition, glyphCellSize}, gm.uvRect, color);
+		vertices.insert(vertices.end(), quad.begin(), quad.end());
+		offset.x += gm.advance;
+	}
+}
+
+
+TextMesh::TextMesh(const Font& font, std::string_view text, Color color)
+{
+	set(font, text, color);
+}
+
+
+/**
+ * Changes the text drawn by the mesh. Geometry is only rebuilt if something changed.
+ */
+void TextMesh::set(const Font& font, std::string_view text, Color color)
+{
+	if (mFont == &font && mText == text && mColor == color)
+	{
+		return;
+	}
+
+	mFont = &font;
+	mText = text;
+	mColor = color;
+	mSize = font.size(text);
+	mVertices.clear();
+	appendVertices(mVertices, font, text, {0, 0}, color);
+}
+
+
+bool TextMesh::empty() const
+{
+	return mVertices.empty();
+}
+
+
+/**
+ * Font the mesh was built with, or nullptr for a default constructed mesh.
+ */
+const Font* TextMesh::font() const
+{
+	return mFont;
+}
+
+
+const std::string& TextMesh::text() const
+{
+	return mText;
+}
+
+
+Color TextMesh::color() const
+{
+	return mColor;
+}
+
+
+/**
+ * Size of the text in pixels, as given by Font::size.
+ */
+Vector<int> TextMesh::size() const
+{
+	return mSize;
+}
+
+
+std::span<const Vertex> TextMesh::vertices() const
+{
+	return mVertices;
+}
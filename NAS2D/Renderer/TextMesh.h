@@ -0,0 +1,63 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Vertex.h"
+#include "../Math/Vector.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Font;
+
+
+	/**
+	 * Glyph geometry for a string of text, built once and drawn many times.
+	 *
+	 * Suited to labels and HUD text that rarely change. Drawing a mesh with
+	 * Renderer::drawTextMesh skips laying out each glyph. Vertex positions are
+	 * relative to the top left of the text.
+	 *
+	 * A mesh refers to its Font, which must outlive it.
+	 */
+	class TextMesh
+	{
+	public:
+		static void appendVertices(std::vector<Vertex>& vertices, const Font& font, std::string_view text, Point<float> position, Color color);
+
+		TextMesh() = default;
+		TextMesh(const Font& font, std::string_view text, Color color = Color::White);
+		TextMesh(const TextMesh&) = default;
+		TextMesh(TextMesh&&) = default;
+		TextMesh& operator=(const TextMesh&) = default;
+		TextMesh& operator=(TextMesh&&) = default;
+
+		void set(const Font& font, std::string_view text, Color color = Color::White);
+
+		bool empty() const;
+		const Font* font() const;
+		const std::string& text() const;
+		Color color() const;
+		Vector<int> size() const;
+		std::span<const Vertex> vertices() const;
+
+	private:
+		const Font* mFont{nullptr};
+		std::string mText{};
+		Color mColor{Color::White};
+		Vector<int> mSize{0, 0};
+		std::vector<Vertex> mVertices{};
+	};
+}
@@ -0,0 +1,239 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "TileMapLayer.h"
+#include "Renderer.h"
+#include "../Resource/Image.h"
+#include "../StringFrom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	Vector<int> chunkGridSize(Vector<int> mapSize)
+	{
+		const auto chunkSize = TileMapLayer::ChunkSize;
+		return {(mapSize.x + chunkSize - 1) / chunkSize, (mapSize.y + chunkSize - 1) / chunkSize};
+	}
+
+
+	/**
+	 * Range [begin, end) of the chunks along one axis that overlap [viewStart, viewEnd).
+	 */
+	std::pair<int, int> visibleChunks(float viewStart, float viewEnd, float chunkLength, int chunkCount)
+	{
+		const auto begin = static_cast<int>(std::floor(viewStart / chunkLength));
+		const auto end = static_cast<int>(std::ceil(viewEnd / chunkLength));
+		return {std::clamp(begin, 0, chunkCount), std::clamp(end, 0, chunkCount)};
+	}
+}
+
+
+TileMapLayer::TileMapLayer(const Image& tileset, Vector<int> tileSize, Vector<int> mapSize) :
+	mTileset{&tileset},
+	mTileSize{tileSize},
+	mMapSize{mapSize},
+	mChunkCount{chunkGridSize(mapSize)},
+	mTilesetColumns{(tileSize.x > 0) ? tileset.size().x / tileSize.x : 0},
+	mTileCount{(tileSize.y > 0) ? mTilesetColumns * (tileset.size().y / tileSize.y) : 0},
+	mTiles(static_cast<std::size_t>(std::max(mapSize.x, 0) * std::max(mapSize.y, 0)), NoTile),
+	mChunks(static_cast<std::size_t>(std::max(mChunkCount.x, 0) * std::max(mChunkCount.y, 0)))
+{
+	if (tileSize.x <= 0 || tileSize.y <= 0)
+	{
+		throw std::runtime_error("TileMapLayer tile size must be positive: " + stringFrom(tileSize));
+	}
+	if (mapSize.x < 0 || mapSize.y < 0)
+	{
+		throw std::runtime_error("TileMapLayer map size must not be negative: " + stringFrom(mapSize));
+	}
+	if (mTileCount == 0)
+	{
+		throw std::runtime_error("TileMapLayer tileset is smaller than one tile: " + stringFrom(tileset.size()));
+	}
+}
+
+
+Vector<int> TileMapLayer::tileSize() const
+{
+	return mTileSize;
+}
+
+
+Vector<int> TileMapLayer::mapSize() const
+{
+	return mMapSize;
+}
+
+
+Vector<int> TileMapLayer::chunkCount() const
+{
+	return mChunkCount;
+}
+
+
+/**
+ * Number of tiles in the tileset.
+ */
+int TileMapLayer::tileCount() const
+{
+	return mTileCount;
+}
+
+
+int TileMapLayer::tile(Point<int> position) const
+{
+	return mTiles[tileIndex(position)];
+}
+
+
+/**
+ * Sets a tile, marking its chunk for rebuilding if it changed.
+ *
+ * \param tileIndex	Index of the tile in the tileset, or NoTile to leave it empty.
+ */
+void TileMapLayer::tile(Point<int> position, int tileIndex)
+{
+	if (tileIndex < NoTile || tileIndex >= mTileCount)
+	{
+		throw std::runtime_error("TileMapLayer tile index out of range: " + std::to_string(tileIndex));
+	}
+
+	auto& currentTile = mTiles[this->tileIndex(position)];
+	if (currentTile == tileIndex) { return; }
+
+	currentTile = tileIndex;
+	chunk(position).dirty = true;
+}
+
+
+void TileMapLayer::fill(int tileIndex)
+{
+	if (tileIndex < NoTile || tileIndex >= mTileCount)
+	{
+		throw std::runtime_error("TileMapLayer tile index out of range: " + std::to_string(tileIndex));
+	}
+
+	std::fill(mTiles.begin(), mTiles.end(), tileIndex);
+	for (auto& chunk : mChunks)
+	{
+		chunk.dirty = true;
+	}
+}
+
+
+/**
+ * Number of chunks waiting to be rebuilt.
+ *
+ * Chunks are rebuilt when next drawn, so chunks that stay out of view are never
+ * rebuilt.
+ */
+std::size_t TileMapLayer::dirtyChunkCount() const
+{
+	return static_cast<std::size_t>(std::count_if(mChunks.begin(), mChunks.end(), [](const Chunk& chunk) { return chunk.dirty; }));
+}
+
+
+/**
+ * Draws the chunks visible on the renderer.
+ *
+ * \return	Number of chunks drawn.
+ */
+std::size_t TileMapLayer::draw(Renderer& renderer, Point<float> position)
+{
+	return draw(renderer, position, {{0, 0}, renderer.size().to<float>()});
+}
+
+
+/**
+ * Draws the chunks overlapping a view area.
+ *
+ * \param position	Where the top left of the map is drawn.
+ * \param viewArea	Area to draw, in the same coordinates as \c position.
+ *
+ * \return	Number of chunks drawn.
+ */
+std::size_t TileMapLayer::draw(Renderer& renderer, Point<float> position, const Rectangle<float>& viewArea)
+{
+	const auto chunkPixelSize = (mTileSize * ChunkSize).to<float>();
+	const auto viewStart = viewArea.position - position;
+	const auto viewEnd = viewArea.endPoint() - position;
+	const auto [beginX, endX] = visibleChunks(viewStart.x, viewEnd.x, chunkPixelSize.x, mChunkCount.x);
+	const auto [beginY, endY] = visibleChunks(viewStart.y, viewEnd.y, chunkPixelSize.y, mChunkCount.y);
+
+	const auto offset = position - Point<float>{0, 0};
+	std::size_t drawnCount = 0;
+	for (int y = beginY; y < endY; ++y)
+	{
+		for (int x = beginX; x < endX; ++x)
+		{
+			auto& chunk = mChunks[static_cast<std::size_t>(y * mChunkCount.x + x)];
+			if (chunk.dirty)
+			{
+				rebuild({x, y}, chunk);
+			}
+			if (chunk.instances.empty()) { continue; }
+
+			renderer.drawImageInstances(*mTileset, chunk.instances, offset);
+			++drawnCount;
+		}
+	}
+	return drawnCount;
+}
+
+
+std::size_t TileMapLayer::tileIndex(Point<int> position) const
+{
+	if (!Rectangle<int>{{0, 0}, mMapSize}.contains(position))
+	{
+		throw std::runtime_error("TileMapLayer position out of bounds: " + stringFrom(position));
+	}
+	return static_cast<std::size_t>(position.y * mMapSize.x + position.x);
+}
+
+
+TileMapLayer::Chunk& TileMapLayer::chunk(Point<int> tilePosition)
+{
+	return mChunks[static_cast<std::size_t>((tilePosition.y / ChunkSize) * mChunkCount.x + tilePosition.x / ChunkSize)];
+}
+
+
+/**
+ * Rebuilds the instances for a chunk's tiles, with positions relative to the map.
+ */
+void TileMapLayer::rebuild(Point<int> chunkPosition, Chunk& chunk)
+{
+	chunk.instances.clear();
+
+	const auto start = Point{chunkPosition.x * ChunkSize, chunkPosition.y * ChunkSize};
+	const auto end = Point{std::min(start.x + ChunkSize, mMapSize.x), std::min(start.y + ChunkSize, mMapSize.y)};
+	const auto tileSize = mTileSize.to<float>();
+	for (int y = start.y; y < end.y; ++y)
+	{
+		for (int x = start.x; x < end.x; ++x)
+		{
+			const auto tileIndex = mTiles[static_cast<std::size_t>(y * mMapSize.x + x)];
+			if (tileIndex == NoTile) { continue; }
+
+			const auto tilesetPosition = Point{tileIndex % mTilesetColumns * mTileSize.x, tileIndex / mTilesetColumns * mTileSize.y}.to<float>();
+			chunk.instances.push_back({Point{static_cast<float>(x), static_cast<float>(y)}.skewBy(tileSize), {tilesetPosition, tileSize}});
+		}
+	}
+
+	chunk.dirty = false;
+}
@@ -0,0 +1,84 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "ImageInstance.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace NAS2D
+{
+	class Image;
+	class Renderer;
+
+
+	/**
+	 * Grid of tiles drawn from a tileset image.
+	 *
+	 * The map is split into square chunks of ChunkSize tiles. Each chunk keeps the
+	 * instances for its tiles, which are only rebuilt after one of its tiles has
+	 * changed, and is drawn with a single Renderer::drawImageInstances call. Chunks
+	 * outside the view area are skipped.
+	 *
+	 * Tiles are numbered left to right, top to bottom across the tileset. A layer
+	 * refers to its tileset, which must outlive it.
+	 */
+	class TileMapLayer
+	{
+	public:
+		static constexpr int ChunkSize = 16;
+		static constexpr int NoTile = -1;
+
+		TileMapLayer(const Image& tileset, Vector<int> tileSize, Vector<int> mapSize);
+		TileMapLayer(const TileMapLayer&) = default;
+		TileMapLayer(TileMapLayer&&) = default;
+		TileMapLayer& operator=(const TileMapLayer&) = default;
+		TileMapLayer& operator=(TileMapLayer&&) = default;
+
+		Vector<int> tileSize() const;
+		Vector<int> mapSize() const;
+		Vector<int> chunkCount() const;
+		int tileCount() const;
+
+		int tile(Point<int> position) const;
+		void tile(Point<int> position, int tileIndex);
+		void fill(int tileIndex);
+
+		std::size_t dirtyChunkCount() const;
+
+		std::size_t draw(Renderer& renderer, Point<float> position);
+		std::size_t draw(Renderer& renderer, Point<float> position, const Rectangle<float>& viewArea);
+
+	private:
+		struct Chunk
+		{
+			std::vector<ImageInstance> instances{};
+			bool dirty{true};
+		};
+
+		std::size_t tileIndex(Point<int> position) const;
+		Chunk& chunk(Point<int> tilePosition);
+		void rebuild(Point<int> chunkPosition, Chunk& chunk);
+
+		const Image* mTileset;
+		Vector<int> mTileSize;
+		Vector<int> mMapSize;
+		Vector<int> mChunkCount;
+		int mTilesetColumns;
+		int mTileCount;
+		std::vector<int> mTiles;
+		std::vector<Chunk> mChunks;
+	};
+}
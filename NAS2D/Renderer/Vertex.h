@@ -0,0 +1,54 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "Color.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+
+#include <array>
+
+
+namespace NAS2D
+{
+	/**
+	 * Interleaved vertex format used for batched geometry submission.
+	 *
+	 * Texture coordinates are normalized to the range [0, 1].
+	 */
+	struct Vertex
+	{
+		Point<float> position;
+		Point<float> textureCoord;
+		Color color;
+	};
+
+
+	/**
+	 * Builds the two triangles covering a rectangle.
+	 */
+	constexpr std::array<Vertex, 6> rectToQuad(const Rectangle<float>& rect, const Rectangle<float>& textureRect, Color color)
+	{
+		const auto p1 = rect.position;
+		const auto p2 = rect.endPoint();
+		const auto t1 = textureRect.position;
+		const auto t2 = textureRect.endPoint();
+
+		return {{
+			{p1, t1, color},
+			{{p1.x, p2.y}, {t1.x, t2.y}, color},
+			{p2, t2, color},
+
+			{p2, t2, color},
+			{{p2.x, p1.y}, {t2.x, t1.y}, color},
+			{p1, t1, color},
+		}};
+	}
+}
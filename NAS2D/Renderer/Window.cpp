@@ -128,6 +128,8 @@ Window::Window(const std::string& appTitle) :
 
 Window::~Window()
 {
+	Utility<EventHandler>::get().windowResized().disconnect({this, &Window::onResize});
+
 	for (auto& [key, cursor] : cursors)
 	{
 		SDL_FreeCursor(cursor);
@@ -354,6 +356,19 @@ void Window::onResize(Vector<int> /*newSize*/)
 }
 
 
+/**
+ * Operates on another Window's native window, for wrappers that forward to it.
+ *
+ * The other Window keeps ownership of the native window, and must outlive this one.
+ */
+void Window::shareWindow(const Window& other)
+{
+	window = other.window;
+	mTitle = other.mTitle;
+	mResolution = other.mResolution;
+}
+
+
 Vector<int> Window::getWindowClientArea() const noexcept
 {
 	Vector<int> clientAreaSize;
@@ -75,6 +75,7 @@ namespace NAS2D
 
 	protected:
 		virtual void onResize(Vector<int> newSize);
+		void shareWindow(const Window& other);
 
 	protected:
 		Vector<int> mResolution{1600, 900};
@@ -0,0 +1,184 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "CollisionMask.h"
+
+#include "../StringFrom.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr int WordBits = 64;
+
+
+	std::size_t wordCount(int bitCount)
+	{
+		return static_cast<std::size_t>((bitCount + WordBits - 1) / WordBits);
+	}
+
+
+	/**
+	 * Gets the 64 bits of a row starting at any bit index. Bits outside the row are 0.
+	 */
+	std::uint64_t bitsAt(std::span<const std::uint64_t> row, int bitIndex)
+	{
+		// Round toward negative infinity, so negative indexes shift the right way
+		const auto wordIndex = (bitIndex >= 0 ? bitIndex : bitIndex - (WordBits - 1)) / WordBits;
+		const auto shift = bitIndex - wordIndex * WordBits;
+
+		const auto wordAt = [&row](int index) -> std::uint64_t {
+			return (index >= 0 && static_cast<std::size_t>(index) < row.size()) ? row[static_cast<std::size_t>(index)] : 0;
+		};
+
+		const auto low = wordAt(wordIndex) >> shift;
+		return shift == 0 ? low : low | (wordAt(wordIndex + 1) << (WordBits - shift));
+	}
+}
+
+
+/**
+ * Creates a mask of the given size with no solid pixels.
+ */
+CollisionMask::CollisionMask(Vector<int> size) :
+	mSize{size},
+	mWordsPerRow{0},
+	mBits{}
+{
+	if (size.x < 0 || size.y < 0)
+	{
+		throw std::runtime_error("CollisionMask size must not be negative: " + stringFrom(size));
+	}
+	mWordsPerRow = wordCount(size.x);
+	mBits.resize(mWordsPerRow * static_cast<std::size_t>(size.y));
+}
+
+
+/**
+ * Creates a mask of all pixels of an image.
+ *
+ * \param pixels			Pixels of the image, from Image::pixels.
+ * \param alphaThreshold	Lowest alpha of a solid pixel.
+ */
+CollisionMask::CollisionMask(const ConstPixelView& pixels, std::uint8_t alphaThreshold) :
+	CollisionMask{pixels, {{0, 0}, pixels.size()}, alphaThreshold}
+{
+}
+
+
+/**
+ * Creates a mask of an area of an image.
+ *
+ * \param pixels			Pixels of the image, from Image::pixels.
+ * \param area				Area of the image to make a mask of.
+ * \param alphaThreshold	Lowest alpha of a solid pixel.
+ */
+CollisionMask::CollisionMask(const ConstPixelView& pixels, Rectangle<int> area, std::uint8_t alphaThreshold) :
+	CollisionMask{area.size}
+{
+	if (!Rectangle{{0, 0}, pixels.size()}.contains(area))
+	{
+		throw std::runtime_error("CollisionMask area out of bounds: " + stringFrom(area));
+	}
+
+	const auto width = static_cast<std::size_t>(area.size.x);
+	for (int y = 0; y < area.size.y; ++y)
+	{
+		const auto pixelRow = pixels.row(area.position.y + y).subspan(static_cast<std::size_t>(area.position.x), width);
+		auto* words = mBits.data() + static_cast<std::size_t>(y) * mWordsPerRow;
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			if (pixelRow[x].alpha >= alphaThreshold)
+			{
+				words[x / WordBits] |= std::uint64_t{1} << (x % WordBits);
+			}
+		}
+	}
+}
+
+
+Vector<int> CollisionMask::size() const
+{
+	return mSize;
+}
+
+
+/**
+ * Checks if a pixel is solid. Points outside the mask are never solid.
+ */
+bool CollisionMask::solid(Point<int> point) const
+{
+	if (!Rectangle{{0, 0}, mSize}.contains(point)) { return false; }
+
+	const auto x = static_cast<std::size_t>(point.x);
+	return (row(point.y)[x / WordBits] >> (x % WordBits)) & 1;
+}
+
+
+void CollisionMask::solid(Point<int> point, bool isSolid)
+{
+	if (!Rectangle{{0, 0}, mSize}.contains(point))
+	{
+		throw std::runtime_error("CollisionMask point out of bounds: " + stringFrom(point));
+	}
+
+	const auto x = static_cast<std::size_t>(point.x);
+	auto& word = mBits[static_cast<std::size_t>(point.y) * mWordsPerRow + x / WordBits];
+	const auto bit = std::uint64_t{1} << (x % WordBits);
+	word = isSolid ? (word | bit) : (word & ~bit);
+}
+
+
+/**
+ * Checks if any solid pixels of two masks overlap.
+ *
+ * Rows of the other mask are shifted into line with this mask's words, and
+ * compared 64 pixels at a time.
+ *
+ * \param other		Mask to test against.
+ * \param offset	Position of the other mask's top left corner, relative to this mask's.
+ */
+bool CollisionMask::overlaps(const CollisionMask& other, Vector<int> offset) const
+{
+	const auto area = Rectangle{{0, 0}, mSize};
+	const auto otherArea = Rectangle{Point{0, 0} + offset, other.mSize};
+	if (area.empty() || otherArea.empty() || !area.overlaps(otherArea)) { return false; }
+
+	const auto firstRow = std::max(0, offset.y);
+	const auto lastRow = std::min(mSize.y, offset.y + other.mSize.y);
+	const auto firstWord = std::max(0, offset.x) / WordBits;
+	const auto lastWord = (std::min(mSize.x, offset.x + other.mSize.x) - 1) / WordBits;
+
+	for (auto y = firstRow; y < lastRow; ++y)
+	{
+		const auto words = row(y);
+		const auto otherWords = other.row(y - offset.y);
+		for (auto word = firstWord; word <= lastWord; ++word)
+		{
+			// Bits past either mask's edge are 0, so need no masking
+			if (words[static_cast<std::size_t>(word)] & bitsAt(otherWords, word * WordBits - offset.x))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+std::span<const std::uint64_t> CollisionMask::row(int y) const
+{
+	return std::span<const std::uint64_t>{mBits}.subspan(static_cast<std::size_t>(y) * mWordsPerRow, mWordsPerRow);
+}
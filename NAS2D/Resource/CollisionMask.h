@@ -0,0 +1,56 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "PixelView.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * One bit per pixel map of which pixels of an image are solid, for pixel
+	 * perfect hit testing.
+	 *
+	 * Pixels are solid if their alpha is at least the mask's alpha threshold. Rows
+	 * are packed into 64 bit words, so overlap tests compare 64 pixels at a time.
+	 * Masks of whole images are cached by Image::collisionMask.
+	 */
+	class CollisionMask
+	{
+	public:
+		static constexpr std::uint8_t DefaultAlphaThreshold = 128;
+
+		explicit CollisionMask(Vector<int> size);
+		explicit CollisionMask(const ConstPixelView& pixels, std::uint8_t alphaThreshold = DefaultAlphaThreshold);
+		CollisionMask(const ConstPixelView& pixels, Rectangle<int> area, std::uint8_t alphaThreshold = DefaultAlphaThreshold);
+
+		Vector<int> size() const;
+
+		bool solid(Point<int> point) const;
+		void solid(Point<int> point, bool isSolid);
+
+		bool overlaps(const CollisionMask& other, Vector<int> offset) const;
+
+	private:
+		std::span<const std::uint64_t> row(int y) const;
+
+		Vector<int> mSize;
+		std::size_t mWordsPerRow;
+		std::vector<std::uint64_t> mBits;
+	};
+}
@@ -9,6 +9,7 @@
 // ==================================================================================
 #include "Font.h"
 
+#include "../Renderer/GLStateCache.h"
 #include "../Filesystem.h"
 #include "../Utility.h"
 #include "../StringFrom.h"
@@ -59,6 +60,7 @@ namespace
 	Font::FontInfo load(std::string_view path, unsigned int ptSize);
 	Font::FontInfo loadBitmap(std::string_view path);
 	unsigned int generateFontTexture(SDL_Surface* fontSurface, std::vector<Font::GlyphMetrics>& glyphMetricsList);
+	std::vector<Color> glyphMapPixels(SDL_Surface* fontSurface);
 	SDL_Surface* generateFontSurface(TTF_Font* font, Vector<int> characterSize);
 	Vector<int> maxCharacterDimensions(TTF_Font* font);
 	Vector<int> roundedCharacterDimensions(Vector<int> maxSize);
@@ -107,7 +109,7 @@ Font::~Font()
 	// However, MacOS shows a segmentation fault when 0 is passed
 	if (mFontInfo.textureId)
 	{
-		glDeleteTextures(1, &mFontInfo.textureId);
+		Utility<GLStateCache>::get().deleteTexture(mFontInfo.textureId);
 	}
 }
 
@@ -228,6 +230,12 @@ unsigned int Font::textureId() const
 }
 
 
+const std::vector<Color>& Font::glyphMap() const
+{
+	return mFontInfo.glyphMap;
+}
+
+
 namespace
 {
 	/**
@@ -270,6 +278,7 @@ namespace
 		fontInfo.ascent = TTF_FontAscent(font);
 		fontInfo.glyphSize = roundedCharSize;
 		fontInfo.textureId = generateFontTexture(fontSurface, glm);
+		fontInfo.glyphMap = glyphMapPixels(fontSurface);
 		SDL_FreeSurface(fontSurface);
 		TTF_CloseFont(font);
 
@@ -322,6 +331,7 @@ namespace
 		fontInfo.ascent = glyphSize.y;
 		fontInfo.glyphSize = glyphSize;
 		fontInfo.textureId = generateFontTexture(fontSurface, glm);
+		fontInfo.glyphMap = glyphMapPixels(fontSurface);
 		SDL_FreeSurface(fontSurface);
 
 		return fontInfo;
@@ -340,6 +350,24 @@ namespace
 	}
 
 
+	/**
+	 * Copies the glyph map pixels in RGBA32 format, for renderers that draw on the CPU.
+	 */
+	std::vector<Color> glyphMapPixels(SDL_Surface* fontSurface)
+	{
+		auto* rgbaSurface = SDL_ConvertSurfaceFormat(fontSurface, SDL_PIXELFORMAT_RGBA32, 0);
+		if (!rgbaSurface)
+		{
+			throw std::runtime_error("Font glyph map conversion failed: " + std::string{SDL_GetError()});
+		}
+
+		const auto* pixels = static_cast<const Color*>(rgbaSurface->pixels);
+		std::vector<Color> glyphMap{pixels, pixels + rgbaSurface->w * rgbaSurface->h};
+		SDL_FreeSurface(rgbaSurface);
+		return glyphMap;
+	}
+
+
 	SDL_Surface* generateFontSurface(TTF_Font* font, Vector<int> characterSize)
 	{
 		const auto matrixSize = characterSize * GlyphMatrixSize;
@@ -11,6 +11,7 @@
 
 #include "../Math/Vector.h"
 #include "../Math/Rectangle.h"
+#include "../Renderer/Color.h"
 
 #include <cstddef>
 #include <string_view>
@@ -57,6 +58,7 @@ namespace NAS2D
 			int ascent{0};
 			Vector<int> glyphSize{};
 			std::vector<GlyphMetrics> metrics{};
+			std::vector<Color> glyphMap{};
 		};
 
 		static Font null();
@@ -82,6 +84,10 @@ namespace NAS2D
 		// As it is so specific, it should not be part of the Font class, nor FontInfo
 		unsigned int textureId() const;
 
+		// Glyph map pixels in RGBA32, 16 x 16 glyph cells
+		// Intended only to be used by RendererSoftware
+		const std::vector<Color>& glyphMap() const;
+
 	protected:
 		Font();
 
@@ -8,10 +8,14 @@
 // = Acknowledgment of your use of NAS2D is appreciated but is not required.
 // ==================================================================================
 #include "Image.h"
+#include "TextureCache.h"
+#include "TextureUploadQueue.h"
 
 #include "../Renderer/Color.h"
+#include "../Renderer/GLStateCache.h"
 #include "../Math/Rectangle.h"
 #include "../Filesystem.h"
+#include "../ThreadPool.h"
 #include "../Utility.h"
 #include "../StringFrom.h"
 
@@ -23,6 +27,7 @@
 #include <SDL2/SDL_image.h>
 #endif
 
+#include <algorithm>
 #include <cstdint>
 #include <utility>
 #include <string>
@@ -33,15 +38,82 @@ using namespace NAS2D;
 
 
 unsigned int generateTexture(SDL_Surface* surface);
-unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height);
+unsigned int generateTexture(const void* buffer, int bytesPerPixel, int width, int height);
 
 
 namespace
 {
 	constexpr bool isBigEndian = SDL_BYTEORDER == SDL_BIG_ENDIAN;
 
-	unsigned int generateFbo(unsigned int textureId, Vector<int> imageSize);
 	unsigned int readPixelValue(std::uintptr_t pixelAddress, unsigned int bytesPerPixel);
+	PixelView::Lock lockSurface(SDL_Surface& surface);
+
+
+	bool gpuMipmapsSupported()
+	{
+		return GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object;
+	}
+
+
+	int mipmapLevelCount(Vector<int> size)
+	{
+		int levelCount = 1;
+		for (auto largest = std::max(size.x, size.y); largest > 1; largest /= 2)
+		{
+			++levelCount;
+		}
+		return levelCount;
+	}
+
+
+	GLint minFilter(Image::TextureFilter filter, bool hasMipmaps)
+	{
+		switch (filter)
+		{
+		case Image::TextureFilter::Nearest:
+			return hasMipmaps ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+		case Image::TextureFilter::Linear:
+			return hasMipmaps ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR;
+		case Image::TextureFilter::Trilinear:
+			return hasMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+		}
+		throw std::runtime_error("Unknown texture filter: " + std::to_string(static_cast<int>(filter)));
+	}
+
+
+	std::vector<Color> copyArea(std::span<const Color> pixels, int width, Rectangle<int> area)
+	{
+		std::vector<Color> areaPixels;
+		areaPixels.reserve(static_cast<std::size_t>(area.size.x * area.size.y));
+		for (int y = area.position.y; y < area.endPoint().y; ++y)
+		{
+			const auto rowStart = pixels.begin() + y * width + area.position.x;
+			areaPixels.insert(areaPixels.end(), rowStart, rowStart + area.size.x);
+		}
+		return areaPixels;
+	}
+
+
+	/**
+	 * Fills in the mipmap levels of the bound texture, each resampled from the level above.
+	 */
+	void uploadResampledMipmaps(std::span<const Color> pixels, Vector<int> size)
+	{
+		std::vector<Color> level;
+		std::vector<Color> nextLevel;
+		auto source = pixels;
+		for (int levelIndex = 1; size.x > 1 || size.y > 1; ++levelIndex)
+		{
+			const auto nextSize = Vector{std::max(size.x / 2, 1), std::max(size.y / 2, 1)};
+			nextLevel.resize(static_cast<std::size_t>(nextSize.x * nextSize.y));
+			resample(source, size, nextLevel, nextSize, ResampleFilter::Lanczos);
+			glTexImage2D(GL_TEXTURE_2D, levelIndex, GL_RGBA, nextSize.x, nextSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nextLevel.data());
+
+			std::swap(level, nextLevel);
+			source = level;
+			size = nextSize;
+		}
+	}
 }
 
 
@@ -92,13 +164,99 @@ SDL_Surface* Image::dataToSdlSurface(void* buffer, int bytesPerPixel, Vector<int
 }
 
 
+SDL_Surface* Image::blankSdlSurface(Vector<int> size)
+{
+	auto* surface = SDL_CreateRGBSurfaceWithFormat(0, size.x, size.y, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (!surface)
+	{
+		throw std::runtime_error("Failed to create SDL surface: size = " + stringFrom(size) + " : " + SDL_GetError());
+	}
+
+	return surface;
+}
+
+
+/**
+ * Loads an Image from disk on the shared ThreadPool.
+ *
+ * Reading and decoding the file happen on a worker thread. The texture is still
+ * created on first use by the renderer, so the Image may be drawn as soon as the
+ * future is ready. Loading many images at once spreads them across all workers.
+ *
+ * \param filePath Path to an image file.
+ * \return	Future holding the Image, or any exception thrown while loading it.
+ */
+std::future<std::unique_ptr<Image>> Image::loadAsync(std::string_view filePath)
+{
+	// Singletons are created here, as Utility<T>::get() is not thread safe.
+	// Decoder libraries are initialized up front for the same reason.
+	Utility<Filesystem>::get();
+	Utility<TextureCache>::get();
+	IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+	return Utility<ThreadPool>::get().submit([path = std::string{filePath}]() {
+		return std::make_unique<Image>(path);
+	});
+}
+
+
 /**
  * Loads an Image from disk.
  *
+ * Files are looked up in the shared TextureCache first, if it is enabled. Files
+ * missing from the cache, or changed since cached, are decoded and cached.
+ *
  * \param filePath Path to an image file.
  */
-Image::Image(std::string_view filePath) :
-	Image{*fileToSdlSurface(filePath)}
+Image::Image(std::string_view filePath)
+{
+	const auto& textureCache = Utility<TextureCache>::get();
+	if (!textureCache.enabled())
+	{
+		mSurface = fileToSdlSurface(filePath);
+		mSize = {mSurface->w, mSurface->h};
+		return;
+	}
+
+	const auto path = VirtualPath{filePath};
+	auto entry = textureCache.find(path);
+	if (!entry)
+	{
+		const auto data = Utility<Filesystem>::get().readFile(path);
+		if (data.size() == 0)
+		{
+			throw std::runtime_error("Image file is empty: " + std::string{filePath});
+		}
+
+		entry = textureCache.find(path, data);
+		if (!entry)
+		{
+			mSurface = dataToSdlSurface(data);
+			mSize = {mSurface->w, mSurface->h};
+			textureCache.store(path, data, rgbaPixels(), mSize);
+			return;
+		}
+	}
+
+	// Pixels are used straight from the mapped cache entry, which must outlive the surface
+	mSurface = SDL_CreateRGBSurfaceWithFormatFrom(entry->pixels.data(), entry->size.x, entry->size.y, 32, entry->size.x * 4, SDL_PIXELFORMAT_RGBA32);
+	if (!mSurface)
+	{
+		throw std::runtime_error("Failed to create SDL surface from cached image: " + std::string{filePath} + " : " + SDL_GetError());
+	}
+	mSize = entry->size;
+	mPixelStorage = std::move(entry->storage);
+}
+
+
+/**
+ * Creates a fully transparent Image, such as for use as a render target.
+ *
+ * \param	size	Size of the Image in pixels.
+ */
+Image::Image(Vector<int> size) :
+	Image{*blankSdlSurface(size)}
 {
 }
 
@@ -125,13 +283,19 @@ Image::Image(SDL_Surface& surface) :
 
 Image::~Image()
 {
-	if (mFrameBufferObjectId != 0)
+	if (mUploadPending)
 	{
-		glDeleteFramebuffers(1, &mFrameBufferObjectId);
+		Utility<TextureUploadQueue>::get().cancel(*this);
+	}
+	detachFromAtlas();
+
+	for (const auto& [area, repeatTexture] : mRepeatTextures)
+	{
+		Utility<GLStateCache>::get().deleteTexture(repeatTexture);
 	}
 	if (mTextureId != 0)
 	{
-		glDeleteTextures(1, &mTextureId);
+		Utility<GLStateCache>::get().deleteTexture(mTextureId);
 	}
 
 	SDL_FreeSurface(mSurface);
@@ -150,6 +314,8 @@ Vector<int> Image::size() const
 /**
  * Gets the color of a pixel at a given coordinate.
  *
+ * Each call locks the image and decodes the pixel. Use pixels() to read many pixels.
+ *
  * \param	point	Coordinates of the pixel to check.
  */
 Color Image::pixelColor(Point<int> point) const
@@ -160,6 +326,7 @@ Color Image::pixelColor(Point<int> point) const
 	}
 
 	if (!mSurface) { throw std::runtime_error("Image has no allocated surface"); }
+	if (mSurfaceStale) { surfacePixels(); }
 
 	uint8_t bytesPerPixel = mSurface->format->BytesPerPixel;
 	const auto unsignedPoint = point.to<std::size_t>();
@@ -177,24 +344,134 @@ Color Image::pixelColor(Point<int> point) const
 }
 
 
-Image Image::resized(Vector<int> newSize) const
+/**
+ * Gets a view for reading the image's pixels in bulk.
+ *
+ * The image is converted to RGBA32 in place the first time this is called on an
+ * image with another pixel format, and stays locked while the view is alive.
+ *
+ * \note	Images rendered into on the GPU have their texture read back first,
+ *			which requires a current OpenGL context and no rendering into the
+ *			image still in progress.
+ */
+ConstPixelView Image::pixels() const
 {
-	const auto* format = mSurface->format;
-	auto resizedSurface = SDL_CreateRGBSurface(0, newSize.x, newSize.y, format->BytesPerPixel * 8, format->Rmask, format->Gmask, format->Bmask, format->Amask);
-	if (!resizedSurface) { throw std::runtime_error("Failed to created resized surface: " + stringFrom(newSize) + " : " + std::string{SDL_GetError()}); }
+	if (!mSurface) { throw std::runtime_error("Image has no allocated surface"); }
+
+	const auto pixels = rgbaPixels();
+	return {pixels, mSize, lockSurface(*mSurface)};
+}
+
+
+/**
+ * Gets a view for changing the image's pixels in bulk.
+ *
+ * The image is moved out of the texture atlas, and its textures and collision
+ * masks are made again from the changed pixels on next use.
+ *
+ * Images rendered into on the GPU have their texture read back first. Their
+ * texture is then replaced too, so the image must not be the current render
+ * target.
+ */
+PixelView Image::editPixels()
+{
+	if (!mSurface) { throw std::runtime_error("Image has no allocated surface"); }
+
+	const auto pixels = surfacePixels();
+	// The surface now holds the latest pixels, so textures can be made from it again
+	mRenderedTo = false;
+	pixelsChanging();
+	return {pixels, mSize, lockSurface(*mSurface)};
+}
+
+
+/**
+ * Gets a mask of the image's solid pixels, for pixel perfect hit testing.
+ *
+ * Masks are made the first time they are used, and cached per alpha threshold.
+ *
+ * \param alphaThreshold	Lowest alpha of a solid pixel.
+ */
+const CollisionMask& Image::collisionMask(std::uint8_t alphaThreshold) const
+{
+	const auto cached = mCollisionMasks.find(alphaThreshold);
+	if (cached != mCollisionMasks.end()) { return cached->second; }
 
-	if (SDL_SoftStretchLinear(mSurface, nullptr, resizedSurface, nullptr))
+	return mCollisionMasks.emplace(alphaThreshold, CollisionMask{pixels(), alphaThreshold}).first->second;
+}
+
+
+/**
+ * Creates a copy of the Image resampled to a new size.
+ *
+ * \param newSize	Size of the new Image in pixels.
+ * \param filter	Filter weighing source pixels. Box or Lanczos give better results
+ *					when downscaling by large factors.
+ */
+Image Image::resized(Vector<int> newSize, ResampleFilter filter) const
+{
+	const auto pixels = rgbaPixels();
+	auto* resizedSurface = blankSdlSurface(newSize);
+
+	try
+	{
+		resample(pixels, mSize, {static_cast<Color*>(resizedSurface->pixels), static_cast<std::size_t>(newSize.x * newSize.y)}, newSize, filter);
+	}
+	catch (...)
 	{
 		SDL_FreeSurface(resizedSurface);
-		throw std::runtime_error("Failed to scale image to new size: " + stringFrom(newSize) + " : " + std::string{SDL_GetError()});
+		throw;
 	}
 
 	return Image{*resizedSurface};
 }
 
 
+Image::Mipmaps Image::mipmaps() const
+{
+	return mMipmaps;
+}
+
+
+/**
+ * Sets how mipmaps are built for the image's textures.
+ *
+ * Mipmaps let draws scaled well below full size read smaller levels of detail,
+ * which alias less and read far less memory. Mipmapped images are not packed
+ * into the TextureAtlas, since neighbouring images would bleed into each other.
+ */
+void Image::mipmaps(Mipmaps mode)
+{
+	if (mMipmaps == mode) { return; }
+	mMipmaps = mode;
+	samplingChanged();
+}
+
+
+Image::TextureFilter Image::textureFilter() const
+{
+	return mTextureFilter;
+}
+
+
+/**
+ * Sets how the image's textures are sampled when drawn scaled.
+ *
+ * Trilinear filtering blends between mipmap levels, and is the same as linear
+ * filtering for images without mipmaps.
+ */
+void Image::textureFilter(TextureFilter filter)
+{
+	if (mTextureFilter == filter) { return; }
+	mTextureFilter = filter;
+	samplingChanged();
+}
+
+
 Image Image::sliced(Rectangle<int> sliceArea) const
 {
+	if (mSurfaceStale) { surfacePixels(); }
+
 	const auto* format = mSurface->format;
 	auto newSurface = SDL_CreateRGBSurface(0, sliceArea.size.x, sliceArea.size.y, format->BytesPerPixel * 8, format->Rmask, format->Gmask, format->Bmask, format->Amask);
 	if (!newSurface) { throw std::runtime_error("Failed to created sliced surface: " + stringFrom(sliceArea) + " : " + std::string{SDL_GetError()}); }
@@ -210,23 +487,285 @@ Image Image::sliced(Rectangle<int> sliceArea) const
 }
 
 
+/**
+ * Gets the image's own texture, creating it the first time this is called.
+ *
+ * A pending upload from the TextureUploadQueue is finished first.
+ */
 unsigned int Image::textureId() const
 {
+	if (mUploadPending)
+	{
+		Utility<TextureUploadQueue>::get().finish(*this);
+	}
 	if (mTextureId == 0)
 	{
-		mTextureId = generateTexture(mSurface);
+		// Mipmaps built on the CPU are RGBA, and every level must share a format
+		mTextureId = (mMipmaps == Mipmaps::Cpu) ? generateTexture(rgbaPixels().data(), 4, mSize.x, mSize.y) : generateTexture(mSurface);
+		applySampling(mTextureId, {{0, 0}, mSize});
 	}
 	return mTextureId;
 }
 
 
-unsigned int Image::frameBufferObjectId() const
+/**
+ * Gets the texture and normalized texture coordinates to draw the whole image with.
+ *
+ * Small images are packed into the shared TextureAtlas the first time this is
+ * called, so they can be batched with other atlased images. Larger images, or
+ * images detached from the atlas, use their own texture. Images still waiting on
+ * the TextureUploadQueue use its placeholder texture.
+ */
+Image::TextureArea Image::textureArea() const
+{
+	if (mUploadPending)
+	{
+		return {Utility<TextureUploadQueue>::get().placeholderTextureId(), {{0.0f, 0.0f}, {1.0f, 1.0f}}};
+	}
+
+	if (mAtlasEligible && !mAtlasRegion)
+	{
+		auto& atlas = Utility<TextureAtlas>::get();
+		if (atlas.accepts(mSize))
+		{
+			auto* rgbaSurface = SDL_ConvertSurfaceFormat(mSurface, SDL_PIXELFORMAT_RGBA32, 0);
+			if (!rgbaSurface) { throw std::runtime_error("Failed to convert image for texture atlas: " + std::string{SDL_GetError()}); }
+
+			const auto pixelCount = static_cast<std::size_t>(mSize.x * mSize.y);
+			mAtlasRegion = atlas.add({static_cast<const Color*>(rgbaSurface->pixels), pixelCount}, mSize);
+			SDL_FreeSurface(rgbaSurface);
+		}
+		mAtlasEligible = mAtlasRegion.has_value();
+	}
+
+	if (mAtlasRegion)
+	{
+		return {mAtlasRegion->textureId, mAtlasRegion->textureRect};
+	}
+	return {textureId(), {{0.0f, 0.0f}, {1.0f, 1.0f}}};
+}
+
+
+/**
+ * Gets a texture holding only an area of the image, for drawing that area repeated.
+ *
+ * Textures can only wrap at their edges, so the area is copied into a texture of
+ * its own. Copies are cached per area until the image is destroyed.
+ *
+ * \return	Texture to draw the area from, or 0 if it can't be copied. Images that
+ *			have been rendered into have no up to date pixels to copy from.
+ */
+unsigned int Image::repeatTextureId(Rectangle<int> area) const
+{
+	if (area == Rectangle{{0, 0}, mSize})
+	{
+		return textureId();
+	}
+	if (mRenderedTo || area.empty() || !Rectangle{{0, 0}, mSize}.contains(area))
+	{
+		return 0;
+	}
+
+	for (const auto& [cachedArea, repeatTexture] : mRepeatTextures)
+	{
+		if (cachedArea == area) { return repeatTexture; }
+	}
+
+	auto areaPixels = copyArea(rgbaPixels(), mSize.x, area);
+	const auto repeatTexture = generateTexture(areaPixels.data(), 4, area.size.x, area.size.y);
+	applySampling(repeatTexture, area);
+	mRepeatTextures.emplace_back(area, repeatTexture);
+	return repeatTexture;
+}
+
+
+/**
+ * Stops drawing this image from the texture atlas.
+ *
+ * Needed before rendering into the image's own texture, since the atlas copy
+ * would no longer match it.
+ */
+void Image::detachFromAtlas() const
+{
+	if (mAtlasRegion)
+	{
+		Utility<TextureAtlas>::get().remove(*mAtlasRegion);
+		mAtlasRegion.reset();
+	}
+	mAtlasEligible = false;
+}
+
+
+/**
+ * Gets the texture to render into, for drawing into the image on the GPU.
+ *
+ * Rendering leaves the surface pixels out of date, so the atlas copy and any
+ * repeat textures copied from them are dropped, and no new ones are made. The
+ * surface is updated from the texture the next time its pixels are used.
+ */
+unsigned int Image::renderTargetTextureId() const
+{
+	detachFromAtlas();
+	mCollisionMasks.clear();
+	mSurfaceStale = true;
+
+	for (const auto& [area, repeatTexture] : mRepeatTextures)
+	{
+		Utility<GLStateCache>::get().deleteTexture(repeatTexture);
+	}
+	mRepeatTextures.clear();
+	mRenderedTo = true;
+
+	return textureId();
+}
+
+
+/**
+ * Builds mipmaps for one of the image's textures, and sets how it is filtered.
+ *
+ * Images that have been rendered into have no up to date pixels, so build their
+ * mipmaps on the GPU. Mipmaps are not updated by later rendering.
+ *
+ * \param textureId	Texture holding an area of the image.
+ * \param area		Area of the image the texture holds.
+ */
+void Image::applySampling(unsigned int textureId, Rectangle<int> area) const
+{
+	Utility<GLStateCache>::get().bindTexture(textureId);
+
+	const auto useCpu = (mMipmaps == Mipmaps::Cpu && !mRenderedTo) || (mMipmaps == Mipmaps::Gpu && !gpuMipmapsSupported());
+	const auto useGpu = !useCpu && mMipmaps != Mipmaps::None && gpuMipmapsSupported();
+	if (useCpu)
+	{
+		const auto pixels = rgbaPixels();
+		if (area == Rectangle{{0, 0}, mSize})
+		{
+			uploadResampledMipmaps(pixels, area.size);
+		}
+		else
+		{
+			uploadResampledMipmaps(copyArea(pixels, mSize.x, area), area.size);
+		}
+	}
+	else if (useGpu)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	const auto hasMipmaps = useCpu || useGpu;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, hasMipmaps ? mipmapLevelCount(area.size) - 1 : 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter(mTextureFilter, hasMipmaps));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mTextureFilter == TextureFilter::Nearest ? GL_NEAREST : GL_LINEAR);
+}
+
+
+/**
+ * Gets the pixels as tightly packed RGBA32 rows, for rendering on the CPU.
+ *
+ * The surface is converted to RGBA32 in place the first time this is called on
+ * an image with another pixel format.
+ */
+std::span<const Color> Image::rgbaPixels() const
+{
+	return surfacePixels();
+}
+
+
+/**
+ * Gets the pixels to draw into, for rendering into the image on the CPU.
+ *
+ * Textures, atlas regions and collision masks made from the old pixels are
+ * dropped, and made again from the new pixels on next use.
+ */
+std::span<Color> Image::renderTargetPixels() const
+{
+	pixelsChanging();
+	return surfacePixels();
+}
+
+
+/**
+ * Drops everything made from the surface pixels, before they are changed.
+ *
+ * An image that has been rendered into on the GPU keeps its texture, since that
+ * holds the only up to date copy of its pixels.
+ */
+void Image::pixelsChanging() const
+{
+	if (mUploadPending)
+	{
+		Utility<TextureUploadQueue>::get().cancel(*this);
+	}
+	detachFromAtlas();
+	mCollisionMasks.clear();
+
+	if (mRepeatTextures.empty() && (mTextureId == 0 || mRenderedTo)) { return; }
+
+	auto& glState = Utility<GLStateCache>::get();
+	for (const auto& [area, repeatTexture] : mRepeatTextures)
+	{
+		glState.deleteTexture(repeatTexture);
+	}
+	mRepeatTextures.clear();
+
+	if (mTextureId != 0 && !mRenderedTo)
+	{
+		glState.deleteTexture(mTextureId);
+		mTextureId = 0;
+	}
+}
+
+
+std::span<Color> Image::surfacePixels() const
 {
-	if (mFrameBufferObjectId == 0)
+	if (mSurface->format->format != SDL_PIXELFORMAT_RGBA32 || mSurface->pitch != mSize.x * 4)
 	{
-		mFrameBufferObjectId = generateFbo(mTextureId, mSize);
+		auto* rgbaSurface = SDL_ConvertSurfaceFormat(mSurface, SDL_PIXELFORMAT_RGBA32, 0);
+		if (!rgbaSurface) { throw std::runtime_error("Failed to convert image to RGBA32: " + std::string{SDL_GetError()}); }
+
+		SDL_FreeSurface(mSurface);
+		mSurface = rgbaSurface;
 	}
-	return mFrameBufferObjectId;
+
+	if (mSurfaceStale)
+	{
+		// Texture rows are stored top down, the same as the surface
+		Utility<GLStateCache>::get().bindTexture(mTextureId);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, mSurface->pixels);
+		mSurfaceStale = false;
+	}
+
+	return {static_cast<Color*>(mSurface->pixels), static_cast<std::size_t>(mSize.x * mSize.y)};
+}
+
+
+/**
+ * Moves the image out of the atlas, and rebuilds textures already created.
+ *
+ * Textures are dropped and created again on next use, except for an image that
+ * has been rendered into, whose texture holds the only copy of its pixels.
+ */
+void Image::samplingChanged()
+{
+	detachFromAtlas();
+	if (mUploadPending) { return; }
+
+	auto& glState = Utility<GLStateCache>::get();
+	for (const auto& [area, repeatTexture] : mRepeatTextures)
+	{
+		glState.deleteTexture(repeatTexture);
+	}
+	mRepeatTextures.clear();
+
+	if (mTextureId == 0) { return; }
+	if (mRenderedTo)
+	{
+		applySampling(mTextureId, {{0, 0}, mSize});
+		return;
+	}
+	glState.deleteTexture(mTextureId);
+	mTextureId = 0;
 }
 
 
@@ -259,31 +798,19 @@ namespace
 	}
 
 
-	/**
-	 * Generates an OpenGL Frame Buffer Object.
-	 */
-	unsigned int generateFbo(unsigned int textureId, Vector<int> imageSize)
+	void unlockSurface(SDL_Surface* surface)
 	{
-		unsigned int framebuffer;
-		glGenFramebuffers(1, &framebuffer);
-		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		SDL_UnlockSurface(surface);
+	}
 
-		if (textureId == 0)
+
+	PixelView::Lock lockSurface(SDL_Surface& surface)
+	{
+		if (SDL_LockSurface(&surface) != 0)
 		{
-			unsigned int textureColorbuffer;
-			glGenTextures(1, &textureColorbuffer);
-			glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
-			const auto textureFormat = (isBigEndian) ? GL_BGRA : GL_RGBA;
-
-			glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, imageSize.x, imageSize.y, 0, textureFormat, GL_UNSIGNED_BYTE, nullptr);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			throw std::runtime_error("Failed to lock image pixels: " + std::string{SDL_GetError()});
 		}
-
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-		return framebuffer;
+		return {&surface, unlockSurface};
 	}
 }
 
@@ -306,7 +833,7 @@ unsigned int generateTexture(SDL_Surface* surface)
 }
 
 
-unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int height)
+unsigned int generateTexture(const void* buffer, int bytesPerPixel, int width, int height)
 {
 	GLint internalFormat = 0;
 	GLenum textureFormat = 0;
@@ -327,7 +854,7 @@ unsigned int generateTexture(void* buffer, int bytesPerPixel, int width, int hei
 
 	GLuint textureId;
 	glGenTextures(1, &textureId);
-	glBindTexture(GL_TEXTURE_2D, textureId);
+	Utility<GLStateCache>::get().bindTexture(textureId);
 
 	// Set texture and pixel handling states.
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -9,9 +9,23 @@
 // ==================================================================================
 #pragma once
 
+#include "CollisionMask.h"
+#include "PixelView.h"
+#include "TextureAtlas.h"
+#include "../Renderer/ImageResample.h"
+#include "../Math/Rectangle.h"
 #include "../Math/Vector.h"
 
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 
 struct SDL_Surface;
@@ -21,8 +35,6 @@ namespace NAS2D
 {
 	struct Color;
 
-	template <typename BaseType> struct Point;
-	template <typename BaseType> struct Rectangle;
 
 
 	/**
@@ -39,13 +51,38 @@ namespace NAS2D
 	 */
 	class Image
 	{
+	public:
+		/**
+		 * How the levels of detail used for minified draws are built.
+		 */
+		enum class Mipmaps
+		{
+			None,
+			Gpu,
+			Cpu,
+		};
+
+		/**
+		 * How texels are sampled when the image is drawn scaled.
+		 */
+		enum class TextureFilter
+		{
+			Nearest,
+			Linear,
+			Trilinear,
+		};
+
 	protected:
 		static SDL_Surface* fileToSdlSurface(std::string_view filePath);
 		static SDL_Surface* dataToSdlSurface(std::string_view data);
 		static SDL_Surface* dataToSdlSurface(void* buffer, int bytesPerPixel, Vector<int> size);
+		static SDL_Surface* blankSdlSurface(Vector<int> size);
 
 	public:
+		static std::future<std::unique_ptr<Image>> loadAsync(std::string_view filePath);
+
 		explicit Image(std::string_view filePath);
+		explicit Image(Vector<int> size);
 		Image(void* buffer, int bytesPerPixel, Vector<int> size);
 		explicit Image(SDL_Surface& surface);
 
@@ -57,19 +94,56 @@ namespace NAS2D
 		Vector<int> size() const;
 
 		Color pixelColor(Point<int> point) const;
+		ConstPixelView pixels() const;
+		PixelView editPixels();
+		const CollisionMask& collisionMask(std::uint8_t alphaThreshold = CollisionMask::DefaultAlphaThreshold) const;
 
-		Image resized(Vector<int> newSize) const;
+		Image resized(Vector<int> newSize, ResampleFilter filter = ResampleFilter::Bilinear) const;
 		Image sliced(Rectangle<int> sliceArea) const;
 
+		Mipmaps mipmaps() const;
+		void mipmaps(Mipmaps mode);
+		TextureFilter textureFilter() const;
+		void textureFilter(TextureFilter filter);
+
 	protected:
 		friend class RendererOpenGL;
+		friend class RendererSoftware;
+		friend class TextureUploadQueue;
+
+		struct TextureArea
+		{
+			unsigned int textureId;
+			Rectangle<float> textureRect;
+		};
+
 		unsigned int textureId() const;
-		unsigned int frameBufferObjectId() const;
+		TextureArea textureArea() const;
+		unsigned int repeatTextureId(Rectangle<int> area) const;
+		void detachFromAtlas() const;
+		unsigned int renderTargetTextureId() const;
+		std::span<const Color> rgbaPixels() const;
+		std::span<Color> renderTargetPixels() const;
+		void applySampling(unsigned int textureId, Rectangle<int> area) const;
 
 	private:
-		SDL_Surface* mSurface{nullptr};
+		void samplingChanged();
+		void pixelsChanging() const;
+		std::span<Color> surfacePixels() const;
+
+		mutable SDL_Surface* mSurface{nullptr};
 		mutable unsigned int mTextureId{0u};
-		mutable unsigned int mFrameBufferObjectId{0u};
+		mutable std::optional<TextureAtlas::Region> mAtlasRegion{};
+		mutable bool mAtlasEligible{true};
+		mutable std::vector<std::pair<Rectangle<int>, unsigned int>> mRepeatTextures{};
+		mutable std::map<std::uint8_t, CollisionMask> mCollisionMasks{};
+		mutable bool mRenderedTo{false};
+		mutable bool mSurfaceStale{false};
+		// Cleared by TextureUploadQueue on the render thread when pipelined
+		mutable std::atomic<bool> mUploadPending{false};
+		Mipmaps mMipmaps{Mipmaps::None};
+		TextureFilter mTextureFilter{TextureFilter::Linear};
 		Vector<int> mSize{0, 0};
+		std::shared_ptr<void> mPixelStorage{};
 	};
 }
@@ -0,0 +1,163 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Renderer/Color.h"
+#include "../Math/Point.h"
+#include "../Math/Rectangle.h"
+#include "../Math/Vector.h"
+#include "../StringFrom.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+struct SDL_Surface;
+
+
+namespace NAS2D
+{
+	/**
+	 * Direct access to the pixels of an Image, as rows of RGBA32 Colors.
+	 *
+	 * The image's surface stays locked for the lifetime of the view, so reading
+	 * many pixels costs no more than indexing an array. Use PixelView to modify
+	 * pixels, and ConstPixelView to only read them.
+	 *
+	 * \note	The image must outlive the view, and should not be drawn while a
+	 *			PixelView of it is alive.
+	 */
+	template <typename PixelType>
+	class BasicPixelView
+	{
+	public:
+		using Lock = std::unique_ptr<SDL_Surface, void (*)(SDL_Surface*)>;
+
+		BasicPixelView(std::span<PixelType> pixels, Vector<int> size, Lock lock) :
+			mPixels{pixels},
+			mSize{size},
+			mLock{std::move(lock)}
+		{
+		}
+
+		Vector<int> size() const
+		{
+			return mSize;
+		}
+
+		/**
+		 * Gets all pixels, in tightly packed rows from the top left.
+		 */
+		std::span<PixelType> pixels() const
+		{
+			return mPixels;
+		}
+
+		std::span<PixelType> row(int y) const
+		{
+			if (y < 0 || y >= mSize.y)
+			{
+				throw std::runtime_error("Pixel row out of bounds: " + std::to_string(y));
+			}
+			return mPixels.subspan(static_cast<std::size_t>(y) * width(), width());
+		}
+
+		PixelType& at(Point<int> point) const
+		{
+			if (!Rectangle{{0, 0}, mSize}.contains(point))
+			{
+				throw std::runtime_error("Pixel coordinates out of bounds: " + stringFrom(point));
+			}
+			return row(point.y)[static_cast<std::size_t>(point.x)];
+		}
+
+		/**
+		 * Copies an area of pixels into a buffer, as tightly packed rows.
+		 */
+		void read(Rectangle<int> area, std::span<Color> destination) const
+		{
+			const auto areaWidth = checkedAreaWidth(area, destination.size());
+			for (int y = 0; y < area.size.y; ++y)
+			{
+				const auto source = row(area.position.y + y).subspan(static_cast<std::size_t>(area.position.x), areaWidth);
+				std::copy(source.begin(), source.end(), destination.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(y) * areaWidth));
+			}
+		}
+
+		std::vector<Color> read(Rectangle<int> area) const
+		{
+			std::vector<Color> destination(static_cast<std::size_t>(std::max(area.size.x, 0)) * static_cast<std::size_t>(std::max(area.size.y, 0)));
+			read(area, destination);
+			return destination;
+		}
+
+		/**
+		 * Copies tightly packed rows of pixels from a buffer into an area.
+		 */
+		void write(Rectangle<int> area, std::span<const Color> source) const requires (!std::is_const_v<PixelType>)
+		{
+			const auto areaWidth = checkedAreaWidth(area, source.size());
+			for (int y = 0; y < area.size.y; ++y)
+			{
+				const auto sourceRow = source.subspan(static_cast<std::size_t>(y) * areaWidth, areaWidth);
+				std::copy(sourceRow.begin(), sourceRow.end(), row(area.position.y + y).begin() + area.position.x);
+			}
+		}
+
+		void fill(Rectangle<int> area, Color color) const requires (!std::is_const_v<PixelType>)
+		{
+			checkArea(area);
+			for (int y = 0; y < area.size.y; ++y)
+			{
+				std::ranges::fill(row(area.position.y + y).subspan(static_cast<std::size_t>(area.position.x), static_cast<std::size_t>(area.size.x)), color);
+			}
+		}
+
+	private:
+		std::size_t width() const
+		{
+			return static_cast<std::size_t>(mSize.x);
+		}
+
+		void checkArea(Rectangle<int> area) const
+		{
+			if (area.size.x < 0 || area.size.y < 0 || !Rectangle{{0, 0}, mSize}.contains(area))
+			{
+				throw std::runtime_error("Pixel area out of bounds: " + stringFrom(area));
+			}
+		}
+
+		std::size_t checkedAreaWidth(Rectangle<int> area, std::size_t bufferSize) const
+		{
+			checkArea(area);
+			const auto areaWidth = static_cast<std::size_t>(area.size.x);
+			if (bufferSize < areaWidth * static_cast<std::size_t>(area.size.y))
+			{
+				throw std::runtime_error("Pixel buffer too small for area: " + stringFrom(area));
+			}
+			return areaWidth;
+		}
+
+		std::span<PixelType> mPixels;
+		Vector<int> mSize;
+		Lock mLock;
+	};
+
+
+	using PixelView = BasicPixelView<Color>;
+	using ConstPixelView = BasicPixelView<const Color>;
+}
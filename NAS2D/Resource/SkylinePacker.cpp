@@ -0,0 +1,163 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "SkylinePacker.h"
+
+#include <algorithm>
+
+
+using namespace NAS2D;
+
+
+SkylinePacker::SkylinePacker(Vector<int> size) :
+	mSize{size},
+	mSkyline{{0, 0, size.x}}
+{
+}
+
+
+/**
+ * Finds space for a rectangle and marks it as used.
+ *
+ * \return	Top left corner of the placed rectangle, or an empty optional if it does not fit.
+ */
+std::optional<Point<int>> SkylinePacker::insert(Vector<int> size)
+{
+	if (size.x <= 0 || size.y <= 0)
+	{
+		return std::nullopt;
+	}
+
+	std::optional<std::size_t> bestIndex;
+	Point<int> bestPosition{0, 0};
+	for (std::size_t i = 0; i < mSkyline.size(); ++i)
+	{
+		const auto y = fitHeight(i, size);
+		if (y && (!bestIndex || *y < bestPosition.y))
+		{
+			bestIndex = i;
+			bestPosition = {mSkyline[i].x, *y};
+		}
+	}
+
+	if (!bestIndex)
+	{
+		return std::nullopt;
+	}
+
+	addSegment(*bestIndex, bestPosition, size);
+	mUsedArea += size.x * size.y;
+	return bestPosition;
+}
+
+
+Vector<int> SkylinePacker::size() const
+{
+	return mSize;
+}
+
+
+/**
+ * Total area of all inserted rectangles.
+ */
+int SkylinePacker::usedArea() const
+{
+	return mUsedArea;
+}
+
+
+/**
+ * Area below the skyline that is not covered by a rectangle, and can no longer be used.
+ */
+int SkylinePacker::wastedArea() const
+{
+	int areaBelowSkyline = 0;
+	for (const auto& segment : mSkyline)
+	{
+		areaBelowSkyline += segment.width * segment.y;
+	}
+	return areaBelowSkyline - mUsedArea;
+}
+
+
+/**
+ * Fraction of the total area covered by inserted rectangles, in the range [0, 1].
+ */
+float SkylinePacker::occupancy() const
+{
+	return static_cast<float>(mUsedArea) / static_cast<float>(mSize.x * mSize.y);
+}
+
+
+/**
+ * Gets the y position a rectangle would rest at if its left edge was placed at the
+ * start of the given segment.
+ */
+std::optional<int> SkylinePacker::fitHeight(std::size_t segmentIndex, Vector<int> size) const
+{
+	const auto x = mSkyline[segmentIndex].x;
+	if (x + size.x > mSize.x)
+	{
+		return std::nullopt;
+	}
+
+	int y = 0;
+	int widthLeft = size.x;
+	for (auto i = segmentIndex; widthLeft > 0; ++i)
+	{
+		y = std::max(y, mSkyline[i].y);
+		if (y + size.y > mSize.y)
+		{
+			return std::nullopt;
+		}
+		widthLeft -= mSkyline[i].width;
+	}
+	return y;
+}
+
+
+void SkylinePacker::addSegment(std::size_t segmentIndex, Point<int> position, Vector<int> size)
+{
+	mSkyline.insert(mSkyline.begin() + static_cast<std::ptrdiff_t>(segmentIndex), {position.x, position.y + size.y, size.x});
+
+	// Trim or remove segments now covered by the new one
+	const auto right = position.x + size.x;
+	for (auto i = segmentIndex + 1; i < mSkyline.size();)
+	{
+		auto& segment = mSkyline[i];
+		if (segment.x >= right)
+		{
+			break;
+		}
+
+		const auto segmentRight = segment.x + segment.width;
+		if (segmentRight <= right)
+		{
+			mSkyline.erase(mSkyline.begin() + static_cast<std::ptrdiff_t>(i));
+			continue;
+		}
+
+		segment.width = segmentRight - right;
+		segment.x = right;
+		break;
+	}
+
+	// Merge neighbouring segments of equal height
+	for (std::size_t i = 0; i + 1 < mSkyline.size();)
+	{
+		if (mSkyline[i].y == mSkyline[i + 1].y)
+		{
+			mSkyline[i].width += mSkyline[i + 1].width;
+			mSkyline.erase(mSkyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+			continue;
+		}
+		++i;
+	}
+}
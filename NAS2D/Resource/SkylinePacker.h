@@ -0,0 +1,57 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Math/Point.h"
+#include "../Math/Vector.h"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Packs rectangles into a fixed size area using the skyline bottom-left heuristic.
+	 *
+	 * The top edge of everything placed so far is tracked as a list of horizontal
+	 * segments. Each new rectangle goes where its top edge ends up lowest, with ties
+	 * going to the leftmost position. Space trapped below the skyline can not be
+	 * reused, and is reported by wastedArea().
+	 */
+	class SkylinePacker
+	{
+	public:
+		explicit SkylinePacker(Vector<int> size);
+
+		std::optional<Point<int>> insert(Vector<int> size);
+
+		Vector<int> size() const;
+		int usedArea() const;
+		int wastedArea() const;
+		float occupancy() const;
+
+	private:
+		struct Segment
+		{
+			int x;
+			int y;
+			int width;
+		};
+
+		std::optional<int> fitHeight(std::size_t segmentIndex, Vector<int> size) const;
+		void addSegment(std::size_t segmentIndex, Point<int> position, Vector<int> size);
+
+		Vector<int> mSize;
+		std::vector<Segment> mSkyline;
+		int mUsedArea{0};
+	};
+}
@@ -0,0 +1,204 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "TextureAtlas.h"
+
+#include "../Renderer/Color.h"
+#include "../Renderer/GLStateCache.h"
+#include "../Utility.h"
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr int Gutter = 1;
+
+
+	/**
+	 * Copies pixels into a buffer with a border that repeats the outermost pixels.
+	 */
+	std::vector<Color> withGutter(std::span<const Color> pixels, Vector<int> size)
+	{
+		const auto paddedSize = size + Vector{Gutter * 2, Gutter * 2};
+		std::vector<Color> padded(static_cast<std::size_t>(paddedSize.x * paddedSize.y));
+		for (int y = 0; y < paddedSize.y; ++y)
+		{
+			const auto sourceY = std::clamp(y - Gutter, 0, size.y - 1);
+			for (int x = 0; x < paddedSize.x; ++x)
+			{
+				const auto sourceX = std::clamp(x - Gutter, 0, size.x - 1);
+				padded[static_cast<std::size_t>(y * paddedSize.x + x)] = pixels[static_cast<std::size_t>(sourceY * size.x + sourceX)];
+			}
+		}
+		return padded;
+	}
+}
+
+
+TextureAtlas::TextureAtlas() :
+	TextureAtlas{DefaultPageSize, DefaultMaxImageSize}
+{
+}
+
+
+/**
+ * \param pageSize		Size of each atlas texture page.
+ * \param maxImageSize	Largest image accepted into the atlas. Use {0, 0} to disable packing.
+ */
+TextureAtlas::TextureAtlas(Vector<int> pageSize, Vector<int> maxImageSize) :
+	mPageSize{pageSize},
+	mMaxImageSize{maxImageSize}
+{
+	if (mMaxImageSize.x + Gutter * 2 > mPageSize.x || mMaxImageSize.y + Gutter * 2 > mPageSize.y)
+	{
+		throw std::runtime_error("TextureAtlas max image size must fit within a page");
+	}
+}
+
+
+TextureAtlas::~TextureAtlas()
+{
+	auto& glState = Utility<GLStateCache>::get();
+	for (const auto& page : mPages)
+	{
+		glState.deleteTexture(page.textureId);
+	}
+}
+
+
+bool TextureAtlas::accepts(Vector<int> imageSize) const
+{
+	return imageSize.x > 0 && imageSize.y > 0 && imageSize.x <= mMaxImageSize.x && imageSize.y <= mMaxImageSize.y;
+}
+
+
+/**
+ * Packs an image into the first page with room for it.
+ *
+ * \param pixels	Image pixels, tightly packed rows in RGBA32 format.
+ * \param imageSize	Size of the image in pixels.
+ *
+ * \return	Where the image was placed, or an empty optional if the atlas does not accept the size.
+ */
+std::optional<TextureAtlas::Region> TextureAtlas::add(std::span<const Color> pixels, Vector<int> imageSize)
+{
+	if (!accepts(imageSize))
+	{
+		return std::nullopt;
+	}
+	if (pixels.size() < static_cast<std::size_t>(imageSize.x * imageSize.y))
+	{
+		throw std::runtime_error("TextureAtlas pixel buffer is smaller than the image size");
+	}
+
+	const auto paddedSize = imageSize + Vector{Gutter * 2, Gutter * 2};
+	const auto padded = withGutter(pixels, imageSize);
+
+	std::lock_guard lock{mMutex};
+	std::optional<Point<int>> position;
+	std::size_t pageIndex = 0;
+	for (; pageIndex < mPages.size(); ++pageIndex)
+	{
+		position = mPages[pageIndex].packer.insert(paddedSize);
+		if (position) { break; }
+	}
+	if (!position)
+	{
+		position = createPage().packer.insert(paddedSize);
+		pageIndex = mPages.size() - 1;
+	}
+	auto& page = mPages[pageIndex];
+	++page.regionCount;
+
+	Utility<GLStateCache>::get().bindTexture(page.textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, position->x, position->y, paddedSize.x, paddedSize.y, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+
+	const auto pageSize = mPageSize.to<float>();
+	const auto imageRect = Rectangle<int>{*position + Vector{Gutter, Gutter}, imageSize}.to<float>();
+	return Region{pageIndex, page.textureId, imageRect.skewInverseBy(pageSize), imageSize};
+}
+
+
+/**
+ * Releases a region.
+ *
+ * Space is reclaimed a page at a time: once every region on a page has been
+ * released, the page is emptied and reused for new images.
+ */
+void TextureAtlas::remove(const Region& region)
+{
+	std::lock_guard lock{mMutex};
+	if (region.page >= mPages.size() || mPages[region.page].textureId != region.textureId)
+	{
+		return;
+	}
+
+	auto& page = mPages[region.page];
+	--page.regionCount;
+	page.releasedArea += (region.size.x + Gutter * 2) * (region.size.y + Gutter * 2);
+
+	if (page.regionCount == 0)
+	{
+		page.packer = SkylinePacker{mPageSize};
+		page.releasedArea = 0;
+	}
+}
+
+
+/**
+ * Reports how full each page is. Areas include the gutter around each image.
+ */
+std::vector<TextureAtlas::PageStats> TextureAtlas::pageStats() const
+{
+	std::lock_guard lock{mMutex};
+	std::vector<PageStats> stats;
+	stats.reserve(mPages.size());
+	for (const auto& page : mPages)
+	{
+		const auto usedArea = page.packer.usedArea() - page.releasedArea;
+		const auto pageArea = mPageSize.x * mPageSize.y;
+		stats.push_back({
+			mPageSize,
+			page.regionCount,
+			usedArea,
+			page.packer.wastedArea() + page.releasedArea,
+			static_cast<float>(usedArea) / static_cast<float>(pageArea),
+		});
+	}
+	return stats;
+}
+
+
+TextureAtlas::Page& TextureAtlas::createPage()
+{
+	unsigned int textureId;
+	glGenTextures(1, &textureId);
+	Utility<GLStateCache>::get().bindTexture(textureId);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mPageSize.x, mPageSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	return mPages.emplace_back(Page{textureId, SkylinePacker{mPageSize}, 0, 0});
+}
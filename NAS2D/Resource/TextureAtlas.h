@@ -0,0 +1,95 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "SkylinePacker.h"
+#include "../Math/Rectangle.h"
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+
+namespace NAS2D
+{
+	struct Color;
+
+
+	/**
+	 * Packs small images into shared texture pages.
+	 *
+	 * Images drawn from the same page can be batched into a single draw call, even when
+	 * they come from different files. Each packed image is surrounded by a one pixel
+	 * gutter copied from its edges, so linear filtering does not bleed in neighbours.
+	 *
+	 * Pages are created on demand. Space freed by remove() is counted as wasted in
+	 * pageStats() until every image on its page has been removed, when the page is
+	 * emptied for reuse. Loading and unloading sets of images, such as levels, reuses
+	 * pages rather than adding new ones.
+	 *
+	 * Images may be added on a render thread while others are removed on the game
+	 * thread, so page state is guarded by a mutex.
+	 *
+	 * \note	Accessed through Utility<TextureAtlas>. Adding images requires a current OpenGL context.
+	 */
+	class TextureAtlas
+	{
+	public:
+		struct Region
+		{
+			std::size_t page;
+			unsigned int textureId;
+			Rectangle<float> textureRect;
+			Vector<int> size;
+		};
+
+		struct PageStats
+		{
+			Vector<int> size;
+			std::size_t regionCount;
+			int usedArea;
+			int wastedArea;
+			float occupancy;
+		};
+
+		static constexpr Vector<int> DefaultPageSize{2048, 2048};
+		static constexpr Vector<int> DefaultMaxImageSize{256, 256};
+
+		TextureAtlas();
+		TextureAtlas(Vector<int> pageSize, Vector<int> maxImageSize);
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+		~TextureAtlas();
+
+		bool accepts(Vector<int> imageSize) const;
+		std::optional<Region> add(std::span<const Color> pixels, Vector<int> imageSize);
+		void remove(const Region& region);
+
+		std::vector<PageStats> pageStats() const;
+
+	private:
+		struct Page
+		{
+			unsigned int textureId;
+			SkylinePacker packer;
+			std::size_t regionCount;
+			int releasedArea;
+		};
+
+		Page& createPage();
+
+		Vector<int> mPageSize;
+		Vector<int> mMaxImageSize;
+		mutable std::mutex mMutex{};
+		std::vector<Page> mPages{};
+	};
+}
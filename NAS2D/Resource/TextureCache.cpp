@@ -0,0 +1,348 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextureCache.h"
+
+#include "../Filesystem.h"
+#include "../StringFrom.h"
+#include "../Utility.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+
+using namespace NAS2D;
+
+
+namespace
+{
+	constexpr std::array<char, 4> Magic{'N', '2', 'D', 'T'};
+	constexpr std::size_t PixelAlignment = 16;
+
+	std::atomic<unsigned int> temporaryFileCount{0};
+
+
+	struct Header
+	{
+		std::array<char, 4> magic;
+		std::uint32_t version;
+		std::int32_t width;
+		std::int32_t height;
+		std::uint64_t sourceSize;
+		std::int64_t sourceModified;
+		std::uint64_t sourceHash;
+		std::uint32_t pathLength;
+		std::uint32_t pixelOffset;
+	};
+
+	static_assert(sizeof(Header) == 48);
+
+
+	/**
+	 * FNV-1a hash. Fast, and plenty to tell revisions of a file apart.
+	 */
+	std::uint64_t hash(std::string_view data)
+	{
+		std::uint64_t value = 14695981039346656037u;
+		for (const auto byte : data)
+		{
+			value = (value ^ static_cast<unsigned char>(byte)) * 1099511628211u;
+		}
+		return value;
+	}
+
+
+	/**
+	 * Read only file mapped into memory copy-on-write, so it can be written to
+	 * without changing the file.
+	 */
+	class MappedFile
+	{
+	public:
+		MappedFile(void* data, std::size_t size) :
+			mData{data},
+			mSize{size}
+		{
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+#if defined(_WIN32)
+			UnmapViewOfFile(mData);
+#else
+			munmap(mData, mSize);
+#endif
+		}
+
+		std::byte* data() const
+		{
+			return static_cast<std::byte*>(mData);
+		}
+
+		std::size_t size() const
+		{
+			return mSize;
+		}
+
+	private:
+		void* mData;
+		std::size_t mSize;
+	};
+
+
+	std::shared_ptr<MappedFile> mapFile(const std::string& path)
+	{
+#if defined(_WIN32)
+		const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) { return nullptr; }
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+		{
+			CloseHandle(file);
+			return nullptr;
+		}
+
+		// The view keeps the file mapped after both handles are closed
+		const auto mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping) { return nullptr; }
+
+		auto* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data) { return nullptr; }
+
+		return std::make_shared<MappedFile>(data, static_cast<std::size_t>(fileSize.QuadPart));
+#else
+		const auto file = open(path.c_str(), O_RDONLY);
+		if (file < 0) { return nullptr; }
+
+		struct stat fileStatus;
+		if (fstat(file, &fileStatus) != 0 || fileStatus.st_size <= 0)
+		{
+			close(file);
+			return nullptr;
+		}
+
+		// The mapping stays valid after the file is closed
+		const auto size = static_cast<std::size_t>(fileStatus.st_size);
+		auto* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		close(file);
+		if (data == MAP_FAILED) { return nullptr; }
+
+		return std::make_shared<MappedFile>(data, size);
+#endif
+	}
+
+
+	/**
+	 * Maps a cache entry, and checks it is complete and was made from the given source path.
+	 */
+	std::shared_ptr<MappedFile> mapEntry(const std::string& entryPath, const VirtualPath& sourcePath, Header& header)
+	{
+		auto file = mapFile(entryPath);
+		if (!file || file->size() < sizeof(Header)) { return nullptr; }
+
+		std::memcpy(&header, file->data(), sizeof(Header));
+		const auto& path = sourcePath.string();
+		const auto pixelBytes = static_cast<std::size_t>(header.width) * static_cast<std::size_t>(header.height) * sizeof(Color);
+		if (header.magic != Magic ||
+			header.version != TextureCache::FormatVersion ||
+			header.width <= 0 ||
+			header.height <= 0 ||
+			header.pathLength != path.size() ||
+			header.pixelOffset < sizeof(Header) + path.size() ||
+			file->size() < header.pixelOffset + pixelBytes ||
+			std::memcmp(file->data() + sizeof(Header), path.data(), path.size()) != 0)
+		{
+			return nullptr;
+		}
+		return file;
+	}
+
+
+	TextureCache::Entry toEntry(std::shared_ptr<MappedFile> file, const Header& header)
+	{
+		auto* pixels = reinterpret_cast<Color*>(file->data() + header.pixelOffset);
+		const auto pixelCount = static_cast<std::size_t>(header.width) * static_cast<std::size_t>(header.height);
+		return {std::move(file), {pixels, pixelCount}, {header.width, header.height}};
+	}
+
+
+	std::string hexString(std::uint64_t value)
+	{
+		constexpr auto digits = "0123456789abcdef";
+		std::string text(16, '0');
+		for (auto i = text.size(); i > 0; --i)
+		{
+			text[i - 1] = digits[value & 0xF];
+			value >>= 4;
+		}
+		return text;
+	}
+}
+
+
+TextureCache::TextureCache() = default;
+
+
+/**
+ * \param directory	Directory holding cache entries. Created when the first entry is stored.
+ */
+TextureCache::TextureCache(RealPath directory) :
+	mDirectory{std::move(directory)},
+	mEnabled{true}
+{
+}
+
+
+bool TextureCache::enabled() const
+{
+	return mEnabled;
+}
+
+
+const RealPath& TextureCache::directory() const
+{
+	return mDirectory;
+}
+
+
+/**
+ * Finds the entry for a source file, if the file is unchanged since it was stored.
+ *
+ * The file's size and modification time are checked, without reading it.
+ */
+std::optional<TextureCache::Entry> TextureCache::find(const VirtualPath& sourcePath) const
+{
+	if (!mEnabled) { return std::nullopt; }
+
+	Header header;
+	auto file = mapEntry(entryPath(sourcePath), sourcePath, header);
+	if (!file) { return std::nullopt; }
+
+	const auto& filesystem = Utility<Filesystem>::get();
+	if (header.sourceSize != filesystem.fileSize(sourcePath) || header.sourceModified != filesystem.modificationTime(sourcePath))
+	{
+		return std::nullopt;
+	}
+	return toEntry(std::move(file), header);
+}
+
+
+/**
+ * Finds the entry for a source file by its contents.
+ *
+ * Finds entries for files that were touched but not changed, such as by a fresh
+ * checkout. The entry is stored again with the new modification time, so the next
+ * lookup by path finds it.
+ */
+std::optional<TextureCache::Entry> TextureCache::find(const VirtualPath& sourcePath, std::string_view sourceData) const
+{
+	if (!mEnabled) { return std::nullopt; }
+
+	Header header;
+	auto file = mapEntry(entryPath(sourcePath), sourcePath, header);
+	if (!file || header.sourceSize != sourceData.size() || header.sourceHash != hash(sourceData))
+	{
+		return std::nullopt;
+	}
+
+	auto entry = toEntry(std::move(file), header);
+	if (header.sourceModified != Utility<Filesystem>::get().modificationTime(sourcePath))
+	{
+		// Never written in place, as other threads may have the entry mapped
+		store(sourcePath, sourceData, entry.pixels, entry.size);
+	}
+	return entry;
+}
+
+
+/**
+ * Stores the decoded pixels of a source file, replacing any previous entry.
+ *
+ * The cache is an optimization only, so failing to write an entry is not an
+ * error. The file is decoded again on the next run.
+ *
+ * \return	True if the entry was written.
+ */
+bool TextureCache::store(const VirtualPath& sourcePath, std::string_view sourceData, std::span<const Color> pixels, Vector<int> size) const
+{
+	if (pixels.size() != static_cast<std::size_t>(size.x) * static_cast<std::size_t>(size.y))
+	{
+		throw std::runtime_error("TextureCache pixel count does not match size: " + std::to_string(pixels.size()) + " for " + stringFrom(size));
+	}
+	if (!mEnabled) { return false; }
+
+	std::error_code error;
+	std::filesystem::create_directories(mDirectory.string(), error);
+	if (error) { return false; }
+
+	const auto& path = sourcePath.string();
+	const auto headerBytes = sizeof(Header) + path.size();
+	const auto pixelOffset = (headerBytes + PixelAlignment - 1) / PixelAlignment * PixelAlignment;
+	const Header header{
+		Magic,
+		FormatVersion,
+		size.x,
+		size.y,
+		sourceData.size(),
+		Utility<Filesystem>::get().modificationTime(sourcePath),
+		hash(sourceData),
+		static_cast<std::uint32_t>(path.size()),
+		static_cast<std::uint32_t>(pixelOffset),
+	};
+	const auto padding = std::string(pixelOffset - headerBytes, '\0');
+
+	// Written under another name first, so a partly written entry is never found.
+	// Names are unique per write, since the same file may be loaded on several threads.
+	const auto finalPath = entryPath(sourcePath);
+	const auto temporaryPath = finalPath + "." + std::to_string(temporaryFileCount++) + ".tmp";
+	{
+		std::ofstream file{temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(path.data(), static_cast<std::streamsize>(path.size()));
+		file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+		file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size_bytes()));
+		if (!file) { return false; }
+	}
+
+	std::filesystem::rename(temporaryPath, finalPath, error);
+	if (error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+
+std::string TextureCache::entryPath(const VirtualPath& sourcePath) const
+{
+	return (mDirectory / RealPath{hexString(hash(sourcePath.string())) + ".rgba"}).string();
+}
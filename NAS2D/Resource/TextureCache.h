@@ -0,0 +1,68 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include "../Renderer/Color.h"
+#include "../Math/Vector.h"
+#include "../FilesystemPath.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+
+namespace NAS2D
+{
+	/**
+	 * Cache of decoded image files, stored as raw RGBA32 pixels.
+	 *
+	 * Decoding compressed image formats dominates loading time for art that rarely
+	 * changes. Each entry holds the pixels of one source file, after a header giving
+	 * the source file's size, modification time and content hash. Found entries are
+	 * memory mapped, so pixels are read from disk only as they are used.
+	 *
+	 * A default constructed cache is disabled. Image looks up files in the shared
+	 * instance, available through Utility<TextureCache>.
+	 */
+	class TextureCache
+	{
+	public:
+		static constexpr std::uint32_t FormatVersion = 1;
+
+		/**
+		 * Pixels of a cache entry. Writes to the pixels are private to this entry,
+		 * and not saved to disk. The pixels stay valid while \c storage is held.
+		 */
+		struct Entry
+		{
+			std::shared_ptr<void> storage;
+			std::span<Color> pixels;
+			Vector<int> size;
+		};
+
+		TextureCache();
+		explicit TextureCache(RealPath directory);
+
+		bool enabled() const;
+		const RealPath& directory() const;
+
+		std::optional<Entry> find(const VirtualPath& sourcePath) const;
+		std::optional<Entry> find(const VirtualPath& sourcePath, std::string_view sourceData) const;
+		bool store(const VirtualPath& sourcePath, std::string_view sourceData, std::span<const Color> pixels, Vector<int> size) const;
+
+	private:
+		std::string entryPath(const VirtualPath& sourcePath) const;
+
+		RealPath mDirectory{};
+		bool mEnabled{false};
+	};
+}
@@ -0,0 +1,291 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#include "TextureUploadQueue.h"
+
+#include "Image.h"
+#include "../Renderer/Color.h"
+#include "../Renderer/GLStateCache.h"
+#include "../Utility.h"
+
+#if defined(__XCODE_BUILD__)
+#include <GLEW/GLEW.h>
+#else
+#include <GL/glew.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+unsigned int generateTexture(const void* buffer, int bytesPerPixel, int width, int height);
+
+
+namespace
+{
+	bool pixelBuffersSupported()
+	{
+		return GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+	}
+
+
+	std::size_t rowBytes(const Image& image)
+	{
+		return static_cast<std::size_t>(image.size().x) * sizeof(Color);
+	}
+}
+
+
+TextureUploadQueue::TextureUploadQueue() :
+	TextureUploadQueue{DefaultBudget}
+{
+}
+
+
+/**
+ * \param bytesPerFrame	Most pixel data process() uploads in one call.
+ */
+TextureUploadQueue::TextureUploadQueue(std::size_t bytesPerFrame) :
+	mBudget{bytesPerFrame}
+{
+	if (mBudget == 0)
+	{
+		throw std::runtime_error("TextureUploadQueue budget must be greater than zero");
+	}
+}
+
+
+TextureUploadQueue::~TextureUploadQueue()
+{
+	for (const auto& pending : mUploads)
+	{
+		pending.image->mUploadPending = false;
+	}
+
+	auto& glState = Utility<GLStateCache>::get();
+	glState.deleteBuffer(mPixelBufferId);
+	if (mPlaceholderTextureId != 0)
+	{
+		glState.deleteTexture(mPlaceholderTextureId);
+	}
+}
+
+
+std::size_t TextureUploadQueue::budget() const
+{
+	std::lock_guard lock{mMutex};
+	return mBudget;
+}
+
+
+/**
+ * Sets the most pixel data process() uploads in one call.
+ *
+ * At least one row of an image is uploaded per call, so images wider than the
+ * budget still make progress.
+ */
+void TextureUploadQueue::budget(std::size_t bytesPerFrame)
+{
+	if (bytesPerFrame == 0)
+	{
+		throw std::runtime_error("TextureUploadQueue budget must be greater than zero");
+	}
+	std::lock_guard lock{mMutex};
+	mBudget = bytesPerFrame;
+}
+
+
+/**
+ * Queues an image to have its texture uploaded over the next few frames.
+ *
+ * Does nothing for images that already have a texture or a pending upload.
+ */
+void TextureUploadQueue::enqueue(const Image& image)
+{
+	if (image.mUploadPending || image.mTextureId != 0 || image.mAtlasRegion)
+	{
+		return;
+	}
+
+	if (image.mAtlasEligible && Utility<TextureAtlas>::get().accepts(image.size()))
+	{
+		image.textureArea();
+		return;
+	}
+
+	const auto size = image.size();
+	image.rgbaPixels();
+	image.mTextureId = generateTexture(nullptr, 4, size.x, size.y);
+	image.mAtlasEligible = false;
+
+	std::lock_guard lock{mMutex};
+	image.mUploadPending = true;
+	mUploads.push_back({&image, 0});
+}
+
+
+bool TextureUploadQueue::isPending(const Image& image) const
+{
+	return image.mUploadPending;
+}
+
+
+std::size_t TextureUploadQueue::pendingCount() const
+{
+	std::lock_guard lock{mMutex};
+	return mUploads.size();
+}
+
+
+/**
+ * Gets the number of bytes of pixel data still to be uploaded.
+ */
+std::size_t TextureUploadQueue::pendingBytes() const
+{
+	std::lock_guard lock{mMutex};
+	std::size_t byteCount = 0;
+	for (const auto& pending : mUploads)
+	{
+		byteCount += static_cast<std::size_t>(pending.image->size().y - pending.nextRow) * rowBytes(*pending.image);
+	}
+	return byteCount;
+}
+
+
+/**
+ * Uploads queued pixel data, oldest image first, up to the budget.
+ *
+ * Called once a frame by RendererOpenGL::update().
+ *
+ * \return	Number of bytes uploaded.
+ */
+std::size_t TextureUploadQueue::process()
+{
+	std::lock_guard lock{mMutex};
+	std::size_t uploadedBytes = 0;
+	while (!mUploads.empty() && uploadedBytes < mBudget)
+	{
+		auto& pending = mUploads.front();
+		const auto remainingRows = pending.image->size().y - pending.nextRow;
+		const auto budgetRows = static_cast<int>(std::min((mBudget - uploadedBytes) / rowBytes(*pending.image), static_cast<std::size_t>(remainingRows)));
+		if (budgetRows == 0 && uploadedBytes > 0) { break; }
+
+		uploadedBytes += upload(pending, std::max(budgetRows, 1));
+		if (pending.nextRow == pending.image->size().y)
+		{
+			complete(*pending.image);
+			mUploads.pop_front();
+		}
+	}
+	return uploadedBytes;
+}
+
+
+/**
+ * Uploads the rest of an image's pixels right away, ignoring the budget.
+ */
+void TextureUploadQueue::finish(const Image& image)
+{
+	std::lock_guard lock{mMutex};
+	const auto iter = std::find_if(mUploads.begin(), mUploads.end(), [&image](const Upload& pending) { return pending.image == &image; });
+	if (iter == mUploads.end()) { return; }
+
+	upload(*iter, image.size().y - iter->nextRow);
+	mUploads.erase(iter);
+	complete(image);
+}
+
+
+/**
+ * Drops an image's pending upload, leaving its texture partly filled.
+ *
+ * Used when the image is destroyed.
+ */
+void TextureUploadQueue::cancel(const Image& image)
+{
+	std::lock_guard lock{mMutex};
+	std::erase_if(mUploads, [&image](const Upload& pending) { return pending.image == &image; });
+	image.mUploadPending = false;
+}
+
+
+/**
+ * Gets the 1x1 transparent texture drawn in place of images with pending uploads.
+ */
+unsigned int TextureUploadQueue::placeholderTextureId()
+{
+	std::lock_guard lock{mMutex};
+	if (mPlaceholderTextureId == 0)
+	{
+		auto pixel = Color::NoAlpha;
+		mPlaceholderTextureId = generateTexture(&pixel, 4, 1, 1);
+	}
+	return mPlaceholderTextureId;
+}
+
+
+/**
+ * Builds mipmaps and sets filtering once all of an image's pixels are uploaded.
+ */
+void TextureUploadQueue::complete(const Image& image)
+{
+	image.mUploadPending = false;
+	image.applySampling(image.mTextureId, {{0, 0}, image.size()});
+}
+
+
+/**
+ * Copies rows of an image's pixels into its texture.
+ *
+ * With pixel buffer objects, the rows are copied into a buffer the driver owns,
+ * and the transfer into the texture runs on the GPU without blocking. The buffer
+ * is orphaned on each upload, so it is never written while still being read.
+ *
+ * \return	Number of bytes uploaded.
+ */
+std::size_t TextureUploadQueue::upload(Upload& pending, int rowCount)
+{
+	const auto& image = *pending.image;
+	const auto width = image.size().x;
+	const auto rows = image.rgbaPixels().subspan(static_cast<std::size_t>(pending.nextRow * width), static_cast<std::size_t>(rowCount * width));
+	const auto byteCount = static_cast<GLsizeiptr>(rows.size_bytes());
+
+	auto& glState = Utility<GLStateCache>::get();
+	glState.bindTexture(image.mTextureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	const auto usePixelBuffer = pixelBuffersSupported();
+	const void* source = rows.data();
+	if (usePixelBuffer)
+	{
+		if (mPixelBufferId == 0)
+		{
+			glGenBuffers(1, &mPixelBufferId);
+		}
+		glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, mPixelBufferId);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, byteCount, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, byteCount, rows.data());
+		// With a pixel buffer bound, the data pointer is a byte offset into the buffer
+		source = nullptr;
+	}
+
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, pending.nextRow, width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, source);
+
+	if (usePixelBuffer)
+	{
+		// Other texture uploads read from client memory
+		glState.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	pending.nextRow += rowCount;
+	return rows.size_bytes();
+}
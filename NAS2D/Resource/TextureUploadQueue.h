@@ -0,0 +1,84 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+
+namespace NAS2D
+{
+	class Image;
+
+
+	/**
+	 * Streams image pixels into textures a few rows at a time.
+	 *
+	 * Creating a texture with glTexImage2D copies all of its pixels at once, which can
+	 * stall the frame an image is first drawn in. Images enqueued here get their texture
+	 * storage right away, and their pixels are uploaded by process() with no more than
+	 * budget() bytes per frame. Uploads go through a pixel buffer object when available,
+	 * so the copy into the texture happens asynchronously on the GPU.
+	 *
+	 * While an upload is pending, the image draws with a 1x1 transparent placeholder
+	 * texture. Anything that needs the whole texture, such as rendering into the image,
+	 * finishes its upload immediately.
+	 *
+	 * Images small enough for the TextureAtlas are packed into it on enqueue instead.
+	 *
+	 * Uploads may be processed on a render thread while images are destroyed on the
+	 * game thread, so the queue is guarded by a mutex.
+	 *
+	 * \note	Accessed through Utility<TextureUploadQueue>. Requires a current OpenGL
+	 *			context for everything but construction and budget().
+	 */
+	class TextureUploadQueue
+	{
+	public:
+		static constexpr std::size_t DefaultBudget = 4 * 1024 * 1024;
+
+		TextureUploadQueue();
+		explicit TextureUploadQueue(std::size_t bytesPerFrame);
+		TextureUploadQueue(const TextureUploadQueue&) = delete;
+		TextureUploadQueue& operator=(const TextureUploadQueue&) = delete;
+		~TextureUploadQueue();
+
+		std::size_t budget() const;
+		void budget(std::size_t bytesPerFrame);
+
+		void enqueue(const Image& image);
+		bool isPending(const Image& image) const;
+		std::size_t pendingCount() const;
+		std::size_t pendingBytes() const;
+
+		std::size_t process();
+		void finish(const Image& image);
+		void cancel(const Image& image);
+
+		unsigned int placeholderTextureId();
+
+	private:
+		struct Upload
+		{
+			const Image* image;
+			int nextRow;
+		};
+
+		void complete(const Image& image);
+		std::size_t upload(Upload& upload, int rowCount);
+
+		mutable std::mutex mMutex{};
+		std::size_t mBudget;
+		std::deque<Upload> mUploads{};
+		unsigned int mPixelBufferId{0u};
+		unsigned int mPlaceholderTextureId{0u};
+	};
+}
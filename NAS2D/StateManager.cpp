@@ -13,6 +13,7 @@
 #include "Utility.h"
 #include "State.h"
 #include "Mixer/Mixer.h"
+#include "Renderer/Renderer.h"
 
 using namespace NAS2D;
 
@@ -53,6 +54,7 @@ void StateManager::setState(State* state)
 	}
 
 	if (mForceStopAudio) { Utility<Mixer>::get().stopAllAudio(); }
+	if (mFinishRendering) { Utility<Renderer>::get().finish(); }
 
 	// Initialize the new one
 	mActiveState.reset(state);
@@ -121,3 +123,14 @@ void StateManager::forceStopAudio(bool b)
 {
 	mForceStopAudio = b;
 }
+
+
+/**
+ * Sets whether or not the StateManager waits for the Renderer to finish
+ * drawing between state changes. Needed when rendering on another thread, so
+ * resources drawn by the old state stay alive until drawn.
+ */
+void StateManager::finishRenderingOnStateChange(bool b)
+{
+	mFinishRendering = b;
+}
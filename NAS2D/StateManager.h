@@ -37,6 +37,7 @@ namespace NAS2D
 		bool active() const;
 
 		void forceStopAudio(bool);
+		void finishRenderingOnStateChange(bool);
 
 	private:
 		void handleQuit();
@@ -44,5 +45,6 @@ namespace NAS2D
 		std::unique_ptr<State> mActiveState;
 		bool mActive;
 		bool mForceStopAudio = false;
+		bool mFinishRendering = false;
 	};
 }
@@ -0,0 +1,174 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+
+using namespace NAS2D;
+
+
+ThreadPool::ThreadPool() :
+	ThreadPool{std::max(std::thread::hardware_concurrency(), 1u)}
+{
+}
+
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		throw std::runtime_error("ThreadPool requires at least one thread");
+	}
+
+	mWorkers.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		mWorkers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+
+/**
+ * Runs any tasks still queued, then joins the worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock{mMutex};
+		mStopping = true;
+	}
+	mTaskAvailable.notify_all();
+
+	for (auto& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+
+std::size_t ThreadPool::threadCount() const
+{
+	return mWorkers.size();
+}
+
+
+/**
+ * Splits the range [0, count) into contiguous chunks and runs them in parallel.
+ *
+ * The calling thread runs the first chunk itself, then helps with queued tasks
+ * while waiting, so nested calls from within a task cannot deadlock the pool.
+ * Blocks until every chunk is done. The first exception thrown by a chunk is
+ * rethrown after all chunks finish.
+ *
+ * \param count		Number of items to process.
+ * \param function	Called with the [begin, end) item range of each chunk.
+ */
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& function)
+{
+	const auto chunkCount = std::min(count, mWorkers.size() + 1);
+	if (chunkCount <= 1)
+	{
+		if (count > 0) { function(0, count); }
+		return;
+	}
+
+	const auto chunkEnd = [count, chunkCount](std::size_t chunk) { return count * chunk / chunkCount; };
+
+	std::vector<std::future<void>> chunks;
+	chunks.reserve(chunkCount - 1);
+	for (std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+	{
+		chunks.push_back(submit([&function, begin = chunkEnd(chunk), end = chunkEnd(chunk + 1)]() { function(begin, end); }));
+	}
+
+	std::exception_ptr error;
+	try
+	{
+		function(0, chunkEnd(1));
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+
+	for (auto& chunk : chunks)
+	{
+		while (chunk.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+		{
+			if (!runPendingTask())
+			{
+				chunk.wait();
+			}
+		}
+
+		try
+		{
+			chunk.get();
+		}
+		catch (...)
+		{
+			if (!error) { error = std::current_exception(); }
+		}
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard lock{mMutex};
+		mTasks.push_back(std::move(task));
+	}
+	mTaskAvailable.notify_one();
+}
+
+
+/**
+ * Runs one queued task on the calling thread, if there is one.
+ */
+bool ThreadPool::runPendingTask()
+{
+	std::function<void()> task;
+	{
+		std::lock_guard lock{mMutex};
+		if (mTasks.empty()) { return false; }
+		task = std::move(mTasks.front());
+		mTasks.pop_front();
+	}
+	task();
+	return true;
+}
+
+
+void ThreadPool::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock{mMutex};
+			mTaskAvailable.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+			if (mTasks.empty()) { return; }
+			task = std::move(mTasks.front());
+			mTasks.pop_front();
+		}
+		task();
+	}
+}
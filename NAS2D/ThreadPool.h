@@ -0,0 +1,72 @@
+// ==================================================================================
+// = NAS2D
+// = Copyright © 2008 - 2020 New Age Software
+// ==================================================================================
+// = NAS2D is distributed under the terms of the zlib license. You are free to copy,
+// = modify and distribute the software under the terms of the zlib license.
+// =
+// = Acknowledgment of your use of NAS2D is appreciated but is not required.
+// ==================================================================================
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace NAS2D
+{
+	/**
+	 * Fixed size pool of worker threads that run queued tasks.
+	 *
+	 * A shared instance is available through Utility<ThreadPool>, sized to the
+	 * number of hardware threads.
+	 */
+	class ThreadPool
+	{
+	public:
+		ThreadPool();
+		explicit ThreadPool(std::size_t threadCount);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool();
+
+		std::size_t threadCount() const;
+
+		/**
+		 * Queues a task to run on a worker thread.
+		 *
+		 * \return	Future holding the task's result, or any exception it threw.
+		 */
+		template <typename Function>
+		std::future<std::invoke_result_t<Function>> submit(Function&& function)
+		{
+			using Result = std::invoke_result_t<Function>;
+			auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+			auto future = task->get_future();
+			enqueue([task]() { (*task)(); });
+			return future;
+		}
+
+		void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& function);
+
+	private:
+		void enqueue(std::function<void()> task);
+		bool runPendingTask();
+		void workerLoop();
+
+		std::vector<std::thread> mWorkers{};
+		std::deque<std::function<void()>> mTasks{};
+		std::mutex mMutex{};
+		std::condition_variable mTaskAvailable{};
+		bool mStopping{false};
+	};
+}
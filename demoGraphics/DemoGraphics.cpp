@@ -11,6 +11,7 @@
 #include "NAS2D/Math/Angle.h"
 
 #include <random>
+#include <vector>
 
 
 namespace
@@ -104,6 +105,10 @@ NAS2D::State* DemoGraphics::update()
 
 	renderer.drawGradient({{10, 60}, {64, 64}}, NAS2D::Color::Blue, NAS2D::Color::Green, NAS2D::Color::Red, NAS2D::Color::Magenta);
 
+	std::vector<NAS2D::Point<float>> noisePoints;
+	std::vector<NAS2D::Color> noiseColors;
+	noisePoints.reserve(2000);
+	noiseColors.reserve(2000);
 	for (auto i = 0u; i < 2000u; ++i)
 	{
 		std::uniform_int_distribution<int> jitterDistribution(0, 63);
@@ -111,8 +116,10 @@ NAS2D::State* DemoGraphics::update()
 
 		const uint8_t grey = static_cast<uint8_t>(jitter()) * 2u + 100u;
 		const auto offset = NAS2D::Vector{jitter(), jitter()};
-		renderer.drawPoint(NAS2D::Point{84, 60} + offset, NAS2D::Color{grey, grey, grey});
+		noisePoints.push_back(NAS2D::Point{84, 60} + offset);
+		noiseColors.push_back(NAS2D::Color{grey, grey, grey});
 	}
+	renderer.drawPoints(noisePoints, noiseColors);
 
 	renderer.drawImage(mSlicedGear, {165, 30});
 
@@ -115,6 +115,15 @@ TEST_F(Filesystem, read) {
 	EXPECT_THROW(fs.readFile(NAS2D::VirtualPath{"FileDoesNotExist.txt"}), std::runtime_error);
 }
 
+TEST_F(Filesystem, fileSizeAndModificationTime) {
+	const auto data = fs.readFile(NAS2D::VirtualPath{"file.txt"});
+	EXPECT_EQ(data.size(), fs.fileSize(NAS2D::VirtualPath{"file.txt"}));
+	EXPECT_EQ(fs.modificationTime(NAS2D::VirtualPath{"file.txt"}), fs.modificationTime(NAS2D::VirtualPath{"file.txt"}));
+
+	EXPECT_THROW(fs.fileSize(NAS2D::VirtualPath{"FileDoesNotExist.txt"}), std::runtime_error);
+	EXPECT_THROW(fs.modificationTime(NAS2D::VirtualPath{"FileDoesNotExist.txt"}), std::runtime_error);
+}
+
 // Test a few related methods. Some don't test well standalone.
 TEST_F(Filesystem, writeReadDeleteExists) {
 	const auto testFilename = NAS2D::VirtualPath{"TestFile.txt"};
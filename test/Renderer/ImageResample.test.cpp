@@ -0,0 +1,68 @@
+#include "NAS2D/Renderer/ImageResample.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	std::vector<NAS2D::Color> testPixels(std::size_t count, unsigned int seed) {
+		std::vector<NAS2D::Color> pixels;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			seed = seed * 1103515245u + 12345u;
+			pixels.push_back({static_cast<uint8_t>(seed >> 24), static_cast<uint8_t>(seed >> 16), static_cast<uint8_t>(seed >> 8), static_cast<uint8_t>((seed >> 4) | 1)});
+		}
+		return pixels;
+	}
+
+	std::vector<NAS2D::Color> resampled(const std::vector<NAS2D::Color>& source, NAS2D::Vector<int> sourceSize, NAS2D::Vector<int> newSize, NAS2D::ResampleFilter filter) {
+		std::vector<NAS2D::Color> destination(static_cast<std::size_t>(newSize.x * newSize.y));
+		NAS2D::resample(source, sourceSize, destination, newSize, filter);
+		return destination;
+	}
+}
+
+
+TEST(ImageResample, sameSizeIsUnchanged) {
+	const auto size = NAS2D::Vector{13, 7};
+	const auto source = testPixels(13 * 7, 1);
+	EXPECT_EQ(source, resampled(source, size, size, NAS2D::ResampleFilter::Box));
+	EXPECT_EQ(source, resampled(source, size, size, NAS2D::ResampleFilter::Bilinear));
+	EXPECT_EQ(source, resampled(source, size, size, NAS2D::ResampleFilter::Lanczos));
+}
+
+TEST(ImageResample, boxDownscaleAverages) {
+	const auto source = std::vector<NAS2D::Color>{
+		{0, 0, 0, 255}, {200, 0, 0, 255}, {0, 100, 0, 255}, {0, 100, 0, 255},
+		{0, 0, 0, 255}, {200, 0, 0, 255}, {0, 100, 0, 255}, {0, 100, 0, 255},
+	};
+	const auto expected = std::vector<NAS2D::Color>{{100, 0, 0, 255}, {0, 100, 0, 255}};
+	EXPECT_EQ(expected, resampled(source, {4, 2}, {2, 1}, NAS2D::ResampleFilter::Box));
+}
+
+TEST(ImageResample, transparentPixelsDoNotBleed) {
+	const auto source = std::vector<NAS2D::Color>{{255, 0, 0, 255}, {0, 0, 255, 0}};
+	const auto expected = std::vector<NAS2D::Color>{{255, 0, 0, 128}};
+	EXPECT_EQ(expected, resampled(source, {2, 1}, {1, 1}, NAS2D::ResampleFilter::Box));
+	EXPECT_EQ(expected, resampled(source, {2, 1}, {1, 1}, NAS2D::ResampleFilter::Bilinear));
+}
+
+TEST(ImageResample, uniformColorStaysUniform) {
+	const auto color = NAS2D::Color{10, 200, 30, 180};
+	const auto source = std::vector<NAS2D::Color>(300 * 200, color);
+	const auto expected = std::vector<NAS2D::Color>(123 * 77, color);
+	EXPECT_EQ(expected, resampled(source, {300, 200}, {123, 77}, NAS2D::ResampleFilter::Lanczos));
+
+	const auto upscaled = std::vector<NAS2D::Color>(400 * 250, color);
+	EXPECT_EQ(upscaled, resampled(source, {300, 200}, {400, 250}, NAS2D::ResampleFilter::Bilinear));
+}
+
+TEST(ImageResample, invalidSizesThrow) {
+	auto pixels = std::vector<NAS2D::Color>(4);
+	EXPECT_THROW(NAS2D::resample(pixels, {2, 2}, pixels, {0, 2}), std::runtime_error);
+	EXPECT_THROW(NAS2D::resample(pixels, {2, 2}, pixels, {3, 2}), std::runtime_error);
+	EXPECT_THROW(NAS2D::resample(pixels, {3, 2}, pixels, {2, 2}), std::runtime_error);
+}
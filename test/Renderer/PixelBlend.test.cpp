@@ -0,0 +1,68 @@
+#include "NAS2D/Renderer/PixelBlend.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace {
+	std::vector<NAS2D::Color> testPixels(std::size_t count, unsigned int seed) {
+		std::vector<NAS2D::Color> pixels;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			seed = seed * 1103515245u + 12345u;
+			pixels.push_back({static_cast<uint8_t>(seed >> 24), static_cast<uint8_t>(seed >> 16), static_cast<uint8_t>(seed >> 8), static_cast<uint8_t>(seed >> 4)});
+		}
+		return pixels;
+	}
+}
+
+
+TEST(PixelBlend, blendPixel) {
+	const auto background = NAS2D::Color{10, 20, 30, 255};
+	EXPECT_EQ(NAS2D::Color::Red, NAS2D::blendPixel(background, NAS2D::Color::Red, NAS2D::Color::White));
+	EXPECT_EQ(background, NAS2D::blendPixel(background, NAS2D::Color{255, 0, 0, 0}, NAS2D::Color::White));
+	EXPECT_EQ(background, NAS2D::blendPixel(background, NAS2D::Color::Red, NAS2D::Color{255, 255, 255, 0}));
+	EXPECT_EQ((NAS2D::Color{0, 0, 0, 255}), NAS2D::blendPixel(NAS2D::Color::White, NAS2D::Color::White, NAS2D::Color::Black));
+	EXPECT_EQ((NAS2D::Color{128, 0, 0, 191}), NAS2D::blendPixel(NAS2D::Color{0, 0, 0, 255}, NAS2D::Color{255, 0, 0, 128}, NAS2D::Color::White));
+}
+
+TEST(PixelBlend, blendRowMatchesBlendPixel) {
+	const auto modulate = NAS2D::Color{200, 100, 255, 180};
+	for (std::size_t count = 0; count < 40; ++count)
+	{
+		const auto source = testPixels(count, 1);
+		auto destination = testPixels(count, 2);
+		auto expected = destination;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			expected[i] = NAS2D::blendPixel(expected[i], source[i], modulate);
+		}
+
+		NAS2D::blendRow(destination, source, modulate);
+		EXPECT_EQ(expected, destination);
+	}
+}
+
+TEST(PixelBlend, blendRowConstantMatchesBlendPixel) {
+	const auto color = NAS2D::Color{40, 150, 220, 90};
+	for (std::size_t count = 0; count < 40; ++count)
+	{
+		auto destination = testPixels(count, 3);
+		auto expected = destination;
+		for (auto& pixel : expected)
+		{
+			pixel = NAS2D::blendPixel(pixel, color, NAS2D::Color::White);
+		}
+
+		NAS2D::blendRow(destination, color);
+		EXPECT_EQ(expected, destination);
+	}
+}
+
+TEST(PixelBlend, blendRowRejectsShortSource) {
+	std::vector<NAS2D::Color> destination(4, NAS2D::Color::Black);
+	const std::vector<NAS2D::Color> source(3, NAS2D::Color::White);
+	EXPECT_THROW(NAS2D::blendRow(destination, source, NAS2D::Color::White), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include "NAS2D/Renderer/RenderLayer.h"
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Renderer/RendererSoftware.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+namespace {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+}
+
+
+TEST(RenderLayer, drawsContentsOnceUntilInvalidated) {
+	int drawCount = 0;
+	NAS2D::RenderLayer layer{{4, 4}, [&drawCount](NAS2D::Renderer& renderer) {
+		++drawCount;
+		renderer.drawBoxFilled({{1, 1}, {2, 2}}, NAS2D::Color::Red);
+	}};
+	EXPECT_EQ((NAS2D::Vector{4, 4}), layer.size());
+	EXPECT_FALSE(layer.isValid());
+
+	NAS2D::RendererRecording recording;
+	layer.draw(recording, {0, 0});
+	layer.draw(recording, {10, 0});
+	EXPECT_TRUE(layer.isValid());
+	EXPECT_EQ(1, drawCount);
+	EXPECT_EQ(1u, recording.count(CommandType::SetRenderTarget));
+	EXPECT_EQ(1u, recording.count(CommandType::ResetRenderTarget));
+	EXPECT_EQ(2u, recording.count(CommandType::DrawImage));
+
+	layer.invalidate();
+	layer.draw(recording, {0, 0});
+	EXPECT_EQ(2, drawCount);
+	EXPECT_EQ(2u, recording.count(CommandType::SetRenderTarget));
+}
+
+TEST(RenderLayer, compositesIntoFrame) {
+	NAS2D::RenderLayer layer{{4, 4}, [](NAS2D::Renderer& renderer) {
+		renderer.drawBoxFilled({{1, 1}, {2, 2}}, NAS2D::Color::Red);
+	}};
+
+	NAS2D::RendererSoftware renderer{{8, 8}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.setOrthoProjection({{0, 0}, {4, 4}});
+	layer.draw(renderer, {2, 2});
+
+	EXPECT_EQ(NAS2D::Color::Red, layer.image().pixelColor({1, 1}));
+	EXPECT_EQ(NAS2D::Color::NoAlpha, layer.image().pixelColor({0, 0}));
+
+	// Projection is restored after drawing the contents, so the layer is drawn scaled
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({5, 5}));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({6, 6}));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({7, 7}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({4, 4}));
+}
+
+TEST(RenderLayer, restoresTargetWhenContentsThrow) {
+	NAS2D::RenderLayer layer{{2, 2}, [](NAS2D::Renderer&) {
+		throw std::runtime_error("draw failed");
+	}};
+
+	NAS2D::RendererRecording recording;
+	EXPECT_THROW(layer.draw(recording, {0, 0}), std::runtime_error);
+	EXPECT_FALSE(layer.isValid());
+	EXPECT_EQ(1u, recording.count(CommandType::ResetRenderTarget));
+}
+
+TEST(RenderLayer, nestedLayersRestoreOuterTarget) {
+	NAS2D::RenderLayer inner{{2, 2}, [](NAS2D::Renderer& renderer) {
+		renderer.drawBoxFilled({{0, 0}, {2, 2}}, NAS2D::Color::Blue);
+	}};
+	NAS2D::RenderLayer outer{{4, 4}, [&inner](NAS2D::Renderer& renderer) {
+		renderer.pushClipRect({{0, 0}, {3, 3}});
+		inner.draw(renderer, {0, 0});
+		EXPECT_EQ(1u, renderer.clipDepth());
+		renderer.drawBoxFilled({{2, 2}, {2, 2}}, NAS2D::Color::Red);
+		renderer.popClipRect();
+	}};
+
+	NAS2D::RendererSoftware renderer{{8, 8}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	outer.draw(renderer, {0, 0});
+
+	// Drawing after the inner layer still goes to the outer layer, clipped
+	EXPECT_EQ(NAS2D::Color::Blue, outer.image().pixelColor({1, 1}));
+	EXPECT_EQ(NAS2D::Color::Red, outer.image().pixelColor({2, 2}));
+	EXPECT_EQ(NAS2D::Color::NoAlpha, outer.image().pixelColor({3, 3}));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({2, 2}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({5, 5}));
+	EXPECT_THROW(renderer.popRenderTarget(), std::runtime_error);
+}
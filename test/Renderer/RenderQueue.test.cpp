@@ -0,0 +1,91 @@
+#include "NAS2D/Renderer/RenderQueue.h"
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Resource/Image.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+
+namespace {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+
+	std::vector<NAS2D::Point<float>> drawnPositions(const NAS2D::RendererRecording& recording) {
+		std::vector<NAS2D::Point<float>> positions;
+		for (const auto& command : recording.commands())
+		{
+			positions.push_back(command.rect.position);
+		}
+		return positions;
+	}
+}
+
+
+TEST(RenderQueue, groupsNonOverlappingDrawsByImage) {
+	const auto body = NAS2D::Image{NAS2D::Vector{2, 2}};
+	const auto bar = NAS2D::Image{NAS2D::Vector{2, 1}};
+
+	NAS2D::RenderQueue queue;
+	queue.drawImage(body, {0, 0});
+	queue.drawImage(bar, {0, 3});
+	queue.drawImage(body, {10, 0});
+	queue.drawImage(bar, {10, 3});
+	EXPECT_EQ(4u, queue.size());
+
+	NAS2D::RendererRecording recording;
+	queue.flush(recording);
+	EXPECT_TRUE(queue.empty());
+	EXPECT_EQ(2u, queue.batchCount());
+
+	const auto expected = std::vector<NAS2D::Point<float>>{{0, 0}, {10, 0}, {0, 3}, {10, 3}};
+	EXPECT_EQ(expected, drawnPositions(recording));
+}
+
+TEST(RenderQueue, overlappingDrawsKeepOrder) {
+	const auto first = NAS2D::Image{NAS2D::Vector{2, 2}};
+	const auto second = NAS2D::Image{NAS2D::Vector{2, 2}};
+
+	NAS2D::RenderQueue queue;
+	queue.drawImage(first, {0, 0});
+	queue.drawImage(second, {1, 1});
+	queue.drawImage(first, {2, 2});
+	queue.drawBoxFilled({{10, 10}, {1, 1}}, NAS2D::Color::Red);
+
+	NAS2D::RendererRecording recording;
+	queue.flush(recording);
+	EXPECT_EQ(4u, queue.batchCount());
+
+	const auto expected = std::vector<NAS2D::Point<float>>{{0, 0}, {1, 1}, {2, 2}, {10, 10}};
+	EXPECT_EQ(expected, drawnPositions(recording));
+	EXPECT_EQ(1u, recording.count(CommandType::DrawBoxFilled));
+}
+
+TEST(RenderQueue, sortsByLayerThenDepth) {
+	const auto image = NAS2D::Image{NAS2D::Vector{2, 2}};
+
+	NAS2D::RenderQueue queue;
+	queue.drawImage(image, {0, 0}, 1, 0.0f);
+	queue.drawImage(image, {1, 0}, 0, 2.0f);
+	queue.drawImage(image, {2, 0}, 0, 1.0f);
+	queue.drawImage(image, {3, 0}, 0, 1.0f);
+
+	NAS2D::RendererRecording recording;
+	queue.flush(recording);
+
+	const auto expected = std::vector<NAS2D::Point<float>>{{2, 0}, {3, 0}, {1, 0}, {0, 0}};
+	EXPECT_EQ(expected, drawnPositions(recording));
+}
+
+TEST(RenderQueue, clearDropsDraws) {
+	const auto image = NAS2D::Image{NAS2D::Vector{2, 2}};
+
+	NAS2D::RenderQueue queue;
+	queue.drawSubImageRotated(image, {0, 0}, {{0, 0}, {1, 1}}, NAS2D::Angle::degrees(45));
+	queue.clear();
+	EXPECT_TRUE(queue.empty());
+
+	NAS2D::RendererRecording recording;
+	queue.flush(recording);
+	EXPECT_TRUE(recording.commands().empty());
+	EXPECT_EQ(0u, queue.batchCount());
+}
@@ -0,0 +1,86 @@
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Renderer/ImageInstance.h"
+#include "NAS2D/Resource/Image.h"
+#include "NAS2D/Math/Point.h"
+#include "NAS2D/Math/Rectangle.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+// RendererRecording records bulk draws as is, so these tests call the Renderer
+// defaults directly to check they break draws down into single item draws
+namespace {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+}
+
+
+TEST(Renderer, drawPointsDefaultsToDrawPoint) {
+	NAS2D::RendererRecording recording;
+	const std::vector<NAS2D::Point<float>> points{{1, 2}, {3, 4}, {5, 6}};
+	const std::vector<NAS2D::Color> colors{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue};
+
+	recording.NAS2D::Renderer::drawPoints(points, colors);
+	recording.NAS2D::Renderer::drawPoints(points, std::vector{NAS2D::Color::White});
+	recording.NAS2D::Renderer::drawPoints({}, {});
+
+	const auto commands = recording.commands();
+	ASSERT_EQ(6u, commands.size());
+	EXPECT_EQ(6u, recording.count(CommandType::DrawPoint));
+	EXPECT_EQ((NAS2D::Point{3.0f, 4.0f}), commands[1].rect.position);
+	EXPECT_EQ(NAS2D::Color::Green, commands[1].colors[0]);
+	EXPECT_EQ(NAS2D::Color::White, commands[4].colors[0]);
+}
+
+TEST(Renderer, drawLinesUsesPairs) {
+	NAS2D::RendererRecording recording;
+	const std::vector<NAS2D::Point<float>> endPoints{{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+
+	recording.NAS2D::Renderer::drawLines(endPoints, std::vector{NAS2D::Color::Red}, 2);
+	ASSERT_EQ(2u, recording.count(CommandType::DrawLine));
+	EXPECT_EQ((NAS2D::Point{2.0f, 2.0f}), recording.commands()[1].rect.position);
+	EXPECT_EQ(2, recording.commands()[1].count);
+
+	EXPECT_THROW(recording.NAS2D::Renderer::drawLines(std::span{endPoints}.first(3), std::vector{NAS2D::Color::Red}), std::runtime_error);
+}
+
+TEST(Renderer, drawBoxes) {
+	NAS2D::RendererRecording recording;
+	const std::vector<NAS2D::Rectangle<float>> rects{{{0, 0}, {1, 1}}, {{2, 2}, {3, 3}}};
+
+	recording.NAS2D::Renderer::drawBoxes(rects, std::vector{NAS2D::Color::Red});
+	recording.NAS2D::Renderer::drawBoxesFilled(rects, std::vector{NAS2D::Color::Red, NAS2D::Color::Blue});
+	EXPECT_EQ(2u, recording.count(CommandType::DrawBox));
+	EXPECT_EQ(2u, recording.count(CommandType::DrawBoxFilled));
+	EXPECT_EQ(NAS2D::Color::Blue, recording.commands()[3].colors[0]);
+}
+
+TEST(Renderer, bulkDrawRejectsColorCountMismatch) {
+	NAS2D::RendererRecording recording;
+	const std::vector<NAS2D::Point<float>> points{{1, 2}, {3, 4}, {5, 6}};
+
+	EXPECT_THROW(recording.drawPoints(points, {}), std::runtime_error);
+	EXPECT_THROW(recording.drawPoints(points, std::vector{NAS2D::Color::Red, NAS2D::Color::Blue}), std::runtime_error);
+	EXPECT_TRUE(recording.commands().empty());
+}
+
+TEST(Renderer, drawImageInstancesDefaultsToDrawSubImageRotated) {
+	uint32_t buffer[2 * 2]{};
+	const auto image = NAS2D::Image{&buffer, 4, {2, 2}};
+	const std::vector<NAS2D::ImageInstance> instances{
+		{{1, 2}, {{0, 0}, {1, 1}}},
+		{{3, 4}, {{1, 1}, {1, 1}}, NAS2D::Angle::degrees(90), NAS2D::Color::Red},
+	};
+
+	NAS2D::RendererRecording recording;
+	recording.NAS2D::Renderer::drawImageInstances(image, instances);
+
+	const auto commands = recording.commands();
+	ASSERT_EQ(2u, commands.size());
+	EXPECT_EQ(2u, recording.count(CommandType::DrawSubImageRotated));
+	EXPECT_EQ((NAS2D::Point{3.0f, 4.0f}), commands[1].rect.position);
+	EXPECT_EQ(NAS2D::Color::Red, commands[1].colors[0]);
+	EXPECT_EQ(90.0f, commands[1].values[0]);
+}
@@ -0,0 +1,127 @@
+#include "NAS2D/Renderer/RendererPipelined.h"
+#include "NAS2D/Renderer/RendererSoftware.h"
+#include "NAS2D/Renderer/GLStateCache.h"
+#include "NAS2D/Resource/Image.h"
+#include "NAS2D/Resource/TextureAtlas.h"
+#include "NAS2D/Resource/TextureUploadQueue.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace {
+	// Uploads images while replaying, and tracks the context thread, as RendererOpenGL does
+	class UploadingRenderer : public NAS2D::RendererRecording {
+	public:
+		void drawImage(const NAS2D::Image& image, NAS2D::Point<float> position, float scale, NAS2D::Color color) override {
+			NAS2D::Utility<NAS2D::TextureUploadQueue>::get().enqueue(image);
+			NAS2D::RendererRecording::drawImage(image, position, scale, color);
+		}
+
+		void update() override {
+			NAS2D::Utility<NAS2D::TextureUploadQueue>::get().process();
+			NAS2D::RendererRecording::update();
+		}
+
+		void acquireContext() override {
+			auto& glState = NAS2D::Utility<NAS2D::GLStateCache>::get();
+			glState.contextThread(std::this_thread::get_id());
+			glState.flushDeletes();
+		}
+
+		void releaseContext() override {
+			auto& glState = NAS2D::Utility<NAS2D::GLStateCache>::get();
+			glState.flushDeletes();
+			glState.contextThread(std::thread::id{});
+		}
+	};
+}
+
+
+TEST(RendererPipelined, requiresRenderer) {
+	EXPECT_THROW(NAS2D::RendererPipelined{nullptr}, std::runtime_error);
+}
+
+TEST(RendererPipelined, submitsFramesOnUpdate) {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+
+	auto recording = std::make_unique<NAS2D::RendererRecording>(NAS2D::Vector{8, 8});
+	auto& target = *recording;
+	NAS2D::RendererPipelined renderer{std::move(recording)};
+	EXPECT_EQ((NAS2D::Vector{8, 8}), renderer.size());
+	EXPECT_EQ(&target, &renderer.renderer());
+
+	renderer.drawBox({{0, 0}, {2, 2}});
+	renderer.update();
+	renderer.drawPoint({1, 1});
+	renderer.drawPoint({2, 2});
+	renderer.update();
+	EXPECT_TRUE(renderer.commands().empty());
+
+	renderer.drawLine({0, 0}, {1, 1});
+	renderer.finish();
+	EXPECT_EQ(2u, target.frameCount());
+	EXPECT_EQ(1u, target.count(CommandType::DrawBox));
+	EXPECT_EQ(2u, target.count(CommandType::DrawPoint));
+	EXPECT_EQ(1u, target.count(CommandType::DrawLine));
+}
+
+TEST(RendererPipelined, finishDrawsPartialFrame) {
+	auto software = std::make_unique<NAS2D::RendererSoftware>(NAS2D::Vector{4, 4});
+	const auto& target = *software;
+	NAS2D::RendererPipelined renderer{std::move(software)};
+
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawBoxFilled({{1, 1}, {2, 2}}, NAS2D::Color::Red);
+	renderer.finish();
+	EXPECT_EQ(NAS2D::Color::Red, target.pixel({1, 1}));
+	EXPECT_EQ(NAS2D::Color::Black, target.pixel({0, 0}));
+
+	renderer.clearScreen(NAS2D::Color::Blue);
+	renderer.update();
+	renderer.finish();
+	EXPECT_EQ(NAS2D::Color::Blue, target.pixel({1, 1}));
+}
+
+TEST(RendererPipelined, destroyImagesWhileReplaying) {
+	NAS2D::Utility<NAS2D::GLStateCache>::init();
+	auto& atlas = NAS2D::Utility<NAS2D::TextureAtlas>::init();
+	// A small budget keeps uploads pending across frames
+	auto& uploadQueue = NAS2D::Utility<NAS2D::TextureUploadQueue>::init(std::size_t{4096});
+
+	{
+		std::vector<std::uint32_t> pixels(300 * 300);
+		std::vector<std::unique_ptr<NAS2D::Image>> previousFrameImages;
+		NAS2D::RendererPipelined renderer{std::make_unique<UploadingRenderer>()};
+		for (int frame = 0; frame < 20; ++frame) {
+			std::vector<std::unique_ptr<NAS2D::Image>> images;
+			for (int i = 0; i < 20; ++i) {
+				// Small images are packed into the atlas, large ones are queued for upload
+				const auto size = (i % 2 == 0) ? NAS2D::Vector{4, 4} : NAS2D::Vector{300, 300};
+				images.push_back(std::make_unique<NAS2D::Image>(pixels.data(), 4, size));
+				renderer.drawImage(*images.back(), {0, 0});
+			}
+			renderer.update();
+
+			// The previous frame has been replayed, so its images are freed while this one replays
+			previousFrameImages = std::move(images);
+		}
+		renderer.finish();
+		previousFrameImages.clear();
+	}
+
+	EXPECT_EQ(0u, uploadQueue.pendingCount());
+	for (const auto& page : atlas.pageStats()) {
+		EXPECT_EQ(0u, page.regionCount);
+	}
+
+	NAS2D::Utility<NAS2D::TextureUploadQueue>::clear();
+	NAS2D::Utility<NAS2D::TextureAtlas>::clear();
+	NAS2D::Utility<NAS2D::GLStateCache>::clear();
+}
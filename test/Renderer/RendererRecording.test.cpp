@@ -0,0 +1,234 @@
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Renderer/TextMesh.h"
+#include "NAS2D/Resource/Image.h"
+#include "NAS2D/Resource/Font.h"
+#include "NAS2D/Math/Angle.h"
+#include "NAS2D/EventHandler.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+
+namespace {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+
+	void drawScene(NAS2D::Renderer& renderer, const NAS2D::Image& image) {
+		renderer.clearScreen(NAS2D::Color::Black);
+		renderer.drawImage(image, {1, 2});
+		renderer.drawSubImageRotated(image, {3, 4}, {{0, 0}, {1, 1}}, NAS2D::Angle::degrees(90), NAS2D::Color::Red);
+		renderer.clipRect({{0, 0}, {10, 10}});
+		renderer.drawLine({0, 0}, {5, 5}, NAS2D::Color::Green, 2);
+		renderer.drawCircle({8, 8}, 4, NAS2D::Color::Blue, 12, {1, 2});
+		renderer.clipRectClear();
+		renderer.drawGradient({{0, 0}, {4, 4}}, NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White);
+		renderer.update();
+	}
+
+	void drawBulkScene(NAS2D::Renderer& renderer, const NAS2D::Image& image, const NAS2D::TextMesh& textMesh) {
+		const std::vector<NAS2D::Point<float>> points{{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+		const std::vector<NAS2D::Rectangle<float>> rects{{{0, 0}, {1, 1}}, {{2, 2}, {3, 3}}};
+		const std::vector<NAS2D::ImageInstance> instances{
+			{{1, 2}, {{0, 0}, {1, 1}}},
+			{{3, 4}, {{0, 0}, {1, 1}}, NAS2D::Angle::degrees(90), NAS2D::Color::Red},
+		};
+
+		renderer.drawPoints(points, std::vector{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White});
+		renderer.drawLines(points, std::vector{NAS2D::Color::Red}, 3);
+		renderer.drawBoxes(rects, std::vector{NAS2D::Color::Red, NAS2D::Color::Blue});
+		renderer.drawBoxesFilled(rects, std::vector{NAS2D::Color::Green});
+		renderer.drawImageInstances(image, instances, {5, 6});
+		renderer.drawTextMesh(textMesh, {7, 8});
+		renderer.update();
+	}
+}
+
+
+TEST(RendererRecording, recordsCommands) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+
+	NAS2D::RendererRecording recording;
+	drawScene(recording, image);
+
+	const auto commands = recording.commands();
+	ASSERT_EQ(9u, commands.size());
+	EXPECT_EQ(CommandType::ClearScreen, commands[0].type);
+	EXPECT_EQ(CommandType::DrawImage, commands[1].type);
+	EXPECT_EQ((NAS2D::Point{1.0f, 2.0f}), commands[1].rect.position);
+	EXPECT_EQ(CommandType::DrawSubImageRotated, commands[2].type);
+	EXPECT_EQ(commands[1].resource, commands[2].resource);
+	EXPECT_EQ(90.0f, commands[2].values[0]);
+	EXPECT_EQ(NAS2D::Color::Red, commands[2].colors[0]);
+	EXPECT_EQ(2, commands[4].count);
+	EXPECT_EQ(CommandType::Update, commands[8].type);
+
+	EXPECT_EQ(1u, recording.count(CommandType::DrawImage));
+	EXPECT_EQ(0u, recording.count(CommandType::DrawText));
+	EXPECT_EQ(1u, recording.frameCount());
+
+	recording.clear();
+	EXPECT_TRUE(recording.commands().empty());
+	EXPECT_EQ(0u, recording.frameCount());
+}
+
+TEST(RendererRecording, replayReproducesCommands) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+
+	NAS2D::RendererRecording recording;
+	drawScene(recording, image);
+
+	NAS2D::RendererRecording replayed;
+	recording.replay(replayed);
+
+	EXPECT_TRUE(recording.differences(replayed).empty());
+}
+
+TEST(RendererRecording, differences) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+
+	NAS2D::RendererRecording recording1;
+	NAS2D::RendererRecording recording2;
+	drawScene(recording1, image);
+	drawScene(recording2, image);
+	EXPECT_TRUE(recording1.differences(recording2).empty());
+
+	recording1.drawPoint({1, 1});
+	recording2.drawPoint({1, 2});
+	recording2.drawPoint({1, 1});
+	EXPECT_EQ((std::vector<std::size_t>{9, 10}), recording1.differences(recording2));
+}
+
+TEST(RendererRecording, serializeRoundTrip) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+
+	NAS2D::RendererRecording recording;
+	drawScene(recording, image);
+
+	NAS2D::RendererRecording loaded;
+	loaded.deserialize(recording.serialize());
+
+	EXPECT_TRUE(recording.differences(loaded).empty());
+	EXPECT_EQ(recording.count(CommandType::DrawImage), loaded.count(CommandType::DrawImage));
+	EXPECT_EQ(1u, loaded.frameCount());
+
+	// Loaded recordings have no resources to replay image commands with
+	NAS2D::RendererRecording replayed;
+	EXPECT_THROW(loaded.replay(replayed), std::runtime_error);
+}
+
+TEST(RendererRecording, recordsBulkDrawsAsSingleCommands) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+	const auto font = NAS2D::Font::null();
+	const auto textMesh = NAS2D::TextMesh{font, "Label", NAS2D::Color::Blue};
+
+	NAS2D::RendererRecording recording;
+	drawBulkScene(recording, image, textMesh);
+
+	const auto commands = recording.commands();
+	ASSERT_EQ(7u, commands.size());
+	EXPECT_EQ(CommandType::DrawPoints, commands[0].type);
+	EXPECT_EQ(4u, recording.points(commands[0]).size());
+	EXPECT_EQ(NAS2D::Color::Blue, recording.colors(commands[0])[2]);
+
+	EXPECT_EQ(CommandType::DrawLines, commands[1].type);
+	EXPECT_EQ(2, commands[1].count);
+	EXPECT_EQ((NAS2D::Point{3.0f, 3.0f}), recording.points(commands[1])[3]);
+	ASSERT_EQ(1u, recording.colors(commands[1]).size());
+	EXPECT_EQ(NAS2D::Color::Red, recording.colors(commands[1])[0]);
+
+	EXPECT_EQ(CommandType::DrawBoxes, commands[2].type);
+	EXPECT_EQ(2u, recording.rects(commands[2]).size());
+	EXPECT_EQ(CommandType::DrawBoxesFilled, commands[3].type);
+
+	EXPECT_EQ(CommandType::DrawImageInstances, commands[4].type);
+	ASSERT_EQ(2u, recording.instances(commands[4]).size());
+	EXPECT_EQ(NAS2D::Color::Red, recording.instances(commands[4])[1].color);
+
+	EXPECT_EQ(CommandType::DrawTextMesh, commands[5].type);
+	EXPECT_EQ("Label", recording.text(commands[5]));
+	EXPECT_EQ(NAS2D::Color::Blue, commands[5].colors[0]);
+
+	// Replaying into another recording forwards the same bulk draws
+	NAS2D::RendererRecording replayed;
+	recording.replay(replayed);
+	EXPECT_TRUE(recording.differences(replayed).empty());
+	EXPECT_EQ(1u, replayed.count(CommandType::DrawTextMesh));
+}
+
+TEST(RendererRecording, bulkDrawDifferences) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+	const auto font = NAS2D::Font::null();
+	const auto textMesh = NAS2D::TextMesh{font, "Label"};
+	const std::vector<NAS2D::Point<float>> points{{1, 1}, {2, 2}};
+
+	NAS2D::RendererRecording recording1;
+	NAS2D::RendererRecording recording2;
+	recording1.drawPoints(points, std::vector{NAS2D::Color::Red});
+	recording2.drawPoints(std::span{points}.first(1), std::vector{NAS2D::Color::Red});
+	drawBulkScene(recording1, image, textMesh);
+	drawBulkScene(recording2, image, textMesh);
+
+	// Later item offsets differ, but only the first draw is a difference
+	EXPECT_EQ((std::vector<std::size_t>{0}), recording1.differences(recording2));
+
+	NAS2D::RendererRecording recording3;
+	recording3.drawPoints(std::span{points}.first(1), std::vector{NAS2D::Color::Red});
+	drawBulkScene(recording3, image, textMesh);
+	recording3.drawBoxes(std::vector{NAS2D::Rectangle<float>{{0, 0}, {1, 1}}}, std::vector{NAS2D::Color::Red});
+	recording2.drawBoxes(std::vector{NAS2D::Rectangle<float>{{0, 0}, {1, 2}}}, std::vector{NAS2D::Color::Red});
+	EXPECT_EQ((std::vector<std::size_t>{8}), recording2.differences(recording3));
+}
+
+TEST(RendererRecording, bulkDrawSerializeRoundTrip) {
+	uint32_t buffer[1 * 1]{};
+	const auto image = NAS2D::Image{&buffer, 4, {1, 1}};
+	const auto font = NAS2D::Font::null();
+	const auto textMesh = NAS2D::TextMesh{font, "Label"};
+
+	NAS2D::RendererRecording recording;
+	drawBulkScene(recording, image, textMesh);
+
+	NAS2D::RendererRecording loaded;
+	loaded.deserialize(recording.serialize());
+	EXPECT_TRUE(recording.differences(loaded).empty());
+	EXPECT_EQ(1u, loaded.count(CommandType::DrawLines));
+
+	// Item ranges are checked against the stored items
+	auto data = recording.serialize();
+	auto command = recording.commands()[0];
+	const auto commandOffset = data.find(std::string_view{reinterpret_cast<const char*>(&command), sizeof(command)});
+	ASSERT_NE(std::string::npos, commandOffset);
+	command.count = 100;
+	std::memcpy(data.data() + commandOffset, &command, sizeof(command));
+	EXPECT_THROW(loaded.deserialize(data), std::runtime_error);
+}
+
+TEST(RendererRecording, deserializeRejectsBadData) {
+	NAS2D::RendererRecording recording;
+	EXPECT_THROW(recording.deserialize(""), std::runtime_error);
+	EXPECT_THROW(recording.deserialize("not a recording file"), std::runtime_error);
+
+	recording.drawPoint({0, 0});
+	auto data = recording.serialize();
+	data.pop_back();
+	EXPECT_THROW(recording.deserialize(data), std::runtime_error);
+}
+
+TEST(RendererRecording, disconnectsFromWindowResize) {
+	auto& windowResized = NAS2D::Utility<NAS2D::EventHandler>::get().windowResized();
+	const auto connectionCount = windowResized.count();
+	{
+		NAS2D::RendererRecording recording;
+		EXPECT_EQ(connectionCount + 1, windowResized.count());
+	}
+	EXPECT_EQ(connectionCount, windowResized.count());
+}
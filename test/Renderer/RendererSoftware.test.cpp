@@ -0,0 +1,274 @@
+#include "NAS2D/Renderer/RendererSoftware.h"
+#include "NAS2D/Renderer/PixelBlend.h"
+#include "NAS2D/Resource/Image.h"
+#include "NAS2D/Math/Angle.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace {
+	std::size_t countPixels(const NAS2D::RendererSoftware& renderer, NAS2D::Color color) {
+		const auto pixels = renderer.pixels();
+		return static_cast<std::size_t>(std::count(pixels.begin(), pixels.end(), color));
+	}
+}
+
+
+TEST(RendererSoftware, clearScreen) {
+	NAS2D::RendererSoftware renderer{{4, 3}};
+	EXPECT_EQ((NAS2D::Vector{4, 3}), renderer.frameSize());
+	ASSERT_EQ(12u, renderer.pixels().size());
+
+	renderer.clearScreen(NAS2D::Color::Blue);
+	EXPECT_EQ(12u, countPixels(renderer, NAS2D::Color::Blue));
+	EXPECT_THROW(renderer.pixel({4, 0}), std::runtime_error);
+}
+
+TEST(RendererSoftware, drawBoxFilledBlends) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+
+	renderer.drawBoxFilled({{1, 1}, {2, 2}}, NAS2D::Color::Red);
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({1, 1}));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({2, 2}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({0, 0}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({3, 3}));
+	EXPECT_EQ(4u, countPixels(renderer, NAS2D::Color::Red));
+
+	const auto translucent = NAS2D::Color{0, 255, 0, 128};
+	renderer.drawBoxFilled({{0, 0}, {4, 4}}, translucent);
+	EXPECT_EQ(NAS2D::blendPixel(NAS2D::Color::Red, translucent, NAS2D::Color::White), renderer.pixel({1, 1}));
+	EXPECT_EQ(NAS2D::blendPixel(NAS2D::Color::Black, translucent, NAS2D::Color::White), renderer.pixel({0, 0}));
+}
+
+TEST(RendererSoftware, clipRect) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+
+	renderer.clipRect({{0, 0}, {2, 1}});
+	renderer.drawBoxFilled({{0, 0}, {4, 4}}, NAS2D::Color::White);
+	renderer.clearScreen(NAS2D::Color::Red);
+	renderer.clipRectClear();
+
+	EXPECT_EQ(2u, countPixels(renderer, NAS2D::Color::Red));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({1, 0}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({2, 0}));
+}
+
+TEST(RendererSoftware, pushClipRectIntersects) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+
+	renderer.pushClipRect({{0, 0}, {3, 3}});
+	renderer.pushClipRect({{2, 2}, {2, 2}});
+	EXPECT_EQ(2u, renderer.clipDepth());
+	renderer.clearScreen(NAS2D::Color::Red);
+	renderer.popClipRect();
+	renderer.drawPoint({0, 0}, NAS2D::Color::Green);
+	renderer.drawPoint({3, 3}, NAS2D::Color::Green);
+	renderer.popClipRect();
+
+	EXPECT_EQ(0u, renderer.clipDepth());
+	EXPECT_EQ(1u, countPixels(renderer, NAS2D::Color::Red));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({2, 2}));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({0, 0}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({3, 3}));
+	EXPECT_THROW(renderer.popClipRect(), std::runtime_error);
+}
+
+TEST(RendererSoftware, culledDrawCount) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+
+	renderer.drawBoxFilled({{5, 0}, {2, 2}}, NAS2D::Color::White);
+	renderer.drawCircleFilled({-10, -10}, 2, NAS2D::Color::White);
+	EXPECT_EQ(2u, renderer.culledDrawCount());
+
+	renderer.pushClipRect({{0, 0}, {2, 2}});
+	renderer.drawBoxFilled({{3, 3}, {1, 1}}, NAS2D::Color::White);
+	renderer.drawBoxFilled({{1, 1}, {2, 2}}, NAS2D::Color::White);
+	renderer.popClipRect();
+	EXPECT_EQ(3u, renderer.culledDrawCount());
+	EXPECT_EQ(1u, countPixels(renderer, NAS2D::Color::White));
+
+	renderer.resetCulledDrawCount();
+	EXPECT_EQ(0u, renderer.culledDrawCount());
+}
+
+TEST(RendererSoftware, renderTargetKeepsClipStack) {
+	const auto target = NAS2D::Image{NAS2D::Vector{2, 2}};
+	NAS2D::RendererSoftware renderer{{4, 4}};
+
+	renderer.pushClipRect({{0, 0}, {1, 1}});
+	renderer.setRenderTarget(target);
+	EXPECT_EQ(0u, renderer.clipDepth());
+	renderer.clearScreen(NAS2D::Color::Red);
+	renderer.resetRenderTarget();
+	EXPECT_EQ(1u, renderer.clipDepth());
+	EXPECT_NO_THROW(renderer.popClipRect());
+
+	EXPECT_EQ(NAS2D::Color::Red, target.pixelColor({1, 1}));
+}
+
+TEST(RendererSoftware, drawImage) {
+	NAS2D::Color buffer[2 * 2]{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White};
+	const auto image = NAS2D::Image{&buffer, 4, {2, 2}};
+
+	NAS2D::RendererSoftware renderer{{6, 6}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawImage(image, {1, 1});
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({1, 1}));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({2, 1}));
+	EXPECT_EQ(NAS2D::Color::Blue, renderer.pixel({1, 2}));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({2, 2}));
+	EXPECT_EQ(32u, countPixels(renderer, NAS2D::Color::Black));
+
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawImage(image, {0, 0}, 2.0f, NAS2D::Color{255, 255, 255, 0});
+	EXPECT_EQ(36u, countPixels(renderer, NAS2D::Color::Black));
+
+	renderer.drawImage(image, {0, 0}, 2.0f);
+	EXPECT_EQ(4u, countPixels(renderer, NAS2D::Color::Red));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({3, 3}));
+}
+
+TEST(RendererSoftware, drawImageRotated) {
+	NAS2D::Color buffer[2 * 2]{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White};
+	const auto image = NAS2D::Image{&buffer, 4, {2, 2}};
+
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawImageRotated(image, {1, 1}, NAS2D::Angle::degrees(180));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({1, 1}));
+	EXPECT_EQ(NAS2D::Color::Blue, renderer.pixel({2, 1}));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({1, 2}));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({2, 2}));
+}
+
+TEST(RendererSoftware, drawImageRepeated) {
+	NAS2D::Color buffer[2 * 1]{NAS2D::Color::Red, NAS2D::Color::Green};
+	const auto image = NAS2D::Image{&buffer, 4, {2, 1}};
+
+	NAS2D::RendererSoftware renderer{{5, 2}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawImageRepeated(image, {{0, 0}, {5, 2}});
+	EXPECT_EQ(6u, countPixels(renderer, NAS2D::Color::Red));
+	EXPECT_EQ(4u, countPixels(renderer, NAS2D::Color::Green));
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({4, 1}));
+}
+
+TEST(RendererSoftware, drawImageToImage) {
+	NAS2D::Color sourceBuffer[1 * 1]{NAS2D::Color::Red};
+	NAS2D::Color destinationBuffer[2 * 2]{NAS2D::Color::Black, NAS2D::Color::Black, NAS2D::Color::Black, NAS2D::Color::Black};
+	const auto source = NAS2D::Image{&sourceBuffer, 4, {1, 1}};
+	const auto destination = NAS2D::Image{&destinationBuffer, 4, {2, 2}};
+
+	NAS2D::RendererSoftware renderer{{1, 1}};
+	renderer.drawImageToImage(source, destination, {1, 0});
+	renderer.drawImageToImage(source, destination, {2, 2});
+	EXPECT_EQ(NAS2D::Color::Red, destination.pixelColor({1, 0}));
+	EXPECT_EQ(NAS2D::Color::Black, destination.pixelColor({0, 0}));
+	EXPECT_EQ(NAS2D::Color::Black, destination.pixelColor({1, 1}));
+}
+
+TEST(RendererSoftware, drawImageToImageUpdatesCollisionMask) {
+	NAS2D::Color sourceBuffer[1 * 1]{NAS2D::Color::Red};
+	const auto source = NAS2D::Image{&sourceBuffer, 4, {1, 1}};
+	const auto destination = NAS2D::Image{NAS2D::Vector{2, 1}};
+	EXPECT_FALSE(destination.collisionMask().solid({1, 0}));
+
+	NAS2D::RendererSoftware renderer{{1, 1}};
+	renderer.drawImageToImage(source, destination, {1, 0});
+	EXPECT_TRUE(destination.collisionMask().solid({1, 0}));
+}
+
+TEST(RendererSoftware, drawLineAndBox) {
+	NAS2D::RendererSoftware renderer{{8, 8}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawLine({1, 2}, {6, 2}, NAS2D::Color::White);
+	EXPECT_EQ(5u, countPixels(renderer, NAS2D::Color::White));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({1, 2}));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({5, 2}));
+
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawBox({{1, 1}, {4, 3}}, NAS2D::Color::White);
+	EXPECT_EQ(10u, countPixels(renderer, NAS2D::Color::White));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({2, 2}));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({4, 3}));
+}
+
+TEST(RendererSoftware, drawCircleFilled) {
+	NAS2D::RendererSoftware renderer{{32, 32}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawCircleFilled({16, 16}, 10, NAS2D::Color::White, 64);
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({16, 16}));
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({6, 16}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({8, 8}));
+	EXPECT_NEAR(314.0, static_cast<double>(countPixels(renderer, NAS2D::Color::White)), 8.0);
+
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.drawCircleFilled({16, 16}, 10, NAS2D::Color::White, 2);
+	EXPECT_EQ(0u, countPixels(renderer, NAS2D::Color::White));
+
+	renderer.drawCircleFilled({16, 16}, 4, NAS2D::Color::White, 16, {2, 1});
+	EXPECT_EQ(NAS2D::Color::White, renderer.pixel({9, 16}));
+	EXPECT_EQ(NAS2D::Color::Black, renderer.pixel({16, 10}));
+}
+
+TEST(RendererSoftware, drawGradient) {
+	NAS2D::RendererSoftware renderer{{2, 2}};
+	renderer.drawGradient({{0, 0}, {2, 2}}, NAS2D::Color::Red, NAS2D::Color::Red, NAS2D::Color::Blue, NAS2D::Color::Blue);
+	const auto left = renderer.pixel({0, 0});
+	const auto right = renderer.pixel({1, 0});
+	EXPECT_GT(left.red, right.red);
+	EXPECT_LT(left.blue, right.blue);
+	EXPECT_EQ(left, renderer.pixel({0, 1}));
+}
+
+TEST(RendererSoftware, orthoProjectionScales) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.setOrthoProjection({{0, 0}, {2, 2}});
+	renderer.drawBoxFilled({{1, 1}, {1, 1}}, NAS2D::Color::Green);
+	EXPECT_EQ(4u, countPixels(renderer, NAS2D::Color::Green));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({2, 2}));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({3, 3}));
+}
+
+TEST(RendererSoftware, clipRectUsesOrthoProjection) {
+	NAS2D::RendererSoftware renderer{{4, 4}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	renderer.setOrthoProjection({{0, 0}, {2, 2}});
+
+	renderer.clipRect({{1, 1}, {1, 1}});
+	renderer.drawBoxFilled({{0, 0}, {2, 2}}, NAS2D::Color::Green);
+	EXPECT_EQ(0u, renderer.culledDrawCount());
+	EXPECT_EQ(4u, countPixels(renderer, NAS2D::Color::Green));
+	EXPECT_EQ(NAS2D::Color::Green, renderer.pixel({2, 2}));
+
+	// Clip rects with negative sizes are normalized
+	renderer.clipRect({{1, 1}, {-1, -1}});
+	renderer.drawBoxFilled({{0, 0}, {0.5f, 0.5f}}, NAS2D::Color::Red);
+	EXPECT_EQ(0u, renderer.culledDrawCount());
+	EXPECT_EQ(NAS2D::Color::Red, renderer.pixel({0, 0}));
+
+	// Changing the projection maps the clip rect again
+	renderer.setOrthoProjection({{0, 0}, {4, 4}});
+	renderer.drawBoxFilled({{0, 0}, {4, 4}}, NAS2D::Color::Blue);
+	EXPECT_EQ(1u, countPixels(renderer, NAS2D::Color::Blue));
+	EXPECT_EQ(NAS2D::Color::Blue, renderer.pixel({0, 0}));
+}
+
+TEST(RendererSoftware, largeDrawsMatchSmallDraws) {
+	// Large enough to be split across threads
+	NAS2D::RendererSoftware renderer{{300, 300}};
+	renderer.clearScreen(NAS2D::Color::Black);
+	const auto translucent = NAS2D::Color{10, 200, 30, 100};
+	renderer.drawBoxFilled({{0, 0}, {300, 300}}, translucent);
+
+	const auto expected = NAS2D::blendPixel(NAS2D::Color::Black, translucent, NAS2D::Color::White);
+	EXPECT_EQ(300u * 300u, countPixels(renderer, expected));
+}
@@ -0,0 +1,41 @@
+#include "NAS2D/Renderer/TextMesh.h"
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Resource/Font.h"
+
+#include <gtest/gtest.h>
+
+
+TEST(TextMesh, defaultEmpty) {
+	const NAS2D::TextMesh textMesh;
+	EXPECT_TRUE(textMesh.empty());
+	EXPECT_EQ(nullptr, textMesh.font());
+	EXPECT_EQ("", textMesh.text());
+	EXPECT_EQ((NAS2D::Vector{0, 0}), textMesh.size());
+}
+
+TEST(TextMesh, nullFontHasNoGeometry) {
+	const auto font = NAS2D::Font::null();
+	NAS2D::TextMesh textMesh{font, "Label", NAS2D::Color::Red};
+	EXPECT_TRUE(textMesh.empty());
+	EXPECT_EQ(&font, textMesh.font());
+	EXPECT_EQ("Label", textMesh.text());
+	EXPECT_EQ(NAS2D::Color::Red, textMesh.color());
+
+	textMesh.set(font, "Other");
+	EXPECT_EQ("Other", textMesh.text());
+	EXPECT_EQ(NAS2D::Color::White, textMesh.color());
+}
+
+TEST(TextMesh, drawTextMeshDefaultsToDrawText) {
+	const auto font = NAS2D::Font::null();
+	const NAS2D::TextMesh textMesh{font, "Label"};
+
+	// Call the base implementation, as RendererRecording records meshes as is
+	NAS2D::RendererRecording recording;
+	recording.NAS2D::Renderer::drawTextMesh(textMesh, {1, 2});
+	recording.NAS2D::Renderer::drawTextMesh(NAS2D::TextMesh{}, {1, 2});
+
+	ASSERT_EQ(1u, recording.commands().size());
+	EXPECT_EQ(NAS2D::RendererRecording::CommandType::DrawText, recording.commands()[0].type);
+	EXPECT_EQ("Label", recording.text(recording.commands()[0]));
+}
@@ -0,0 +1,79 @@
+#include "NAS2D/Renderer/TileMapLayer.h"
+#include "NAS2D/Renderer/RendererRecording.h"
+#include "NAS2D/Resource/Image.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+
+namespace {
+	using CommandType = NAS2D::RendererRecording::CommandType;
+}
+
+
+TEST(TileMapLayer, setTiles) {
+	uint32_t buffer[4 * 2]{};
+	const auto tileset = NAS2D::Image{&buffer, 4, {4, 2}};
+	NAS2D::TileMapLayer layer{tileset, {2, 2}, {40, 20}};
+
+	EXPECT_EQ(2, layer.tileCount());
+	EXPECT_EQ((NAS2D::Vector{3, 2}), layer.chunkCount());
+	EXPECT_EQ(NAS2D::TileMapLayer::NoTile, layer.tile({39, 19}));
+
+	layer.tile({39, 19}, 1);
+	EXPECT_EQ(1, layer.tile({39, 19}));
+	EXPECT_THROW(layer.tile({40, 0}, 0), std::runtime_error);
+	EXPECT_THROW(layer.tile({0, 0}, 2), std::runtime_error);
+	EXPECT_THROW((NAS2D::TileMapLayer{tileset, {8, 8}, {1, 1}}), std::runtime_error);
+}
+
+TEST(TileMapLayer, drawCullsAndSkipsEmptyChunks) {
+	uint32_t buffer[4 * 2]{};
+	const auto tileset = NAS2D::Image{&buffer, 4, {4, 2}};
+	NAS2D::TileMapLayer layer{tileset, {2, 2}, {40, 20}};
+	layer.tile({0, 0}, 0);
+	layer.tile({1, 0}, 1);
+	layer.tile({20, 0}, 1);
+	layer.tile({39, 19}, 1);
+
+	NAS2D::RendererRecording recording;
+	EXPECT_EQ(1u, layer.draw(recording, {10, 10}, {{0, 0}, {32, 32}}));
+	ASSERT_EQ(1u, recording.count(CommandType::DrawImageInstances));
+	const auto& command = recording.commands()[0];
+	EXPECT_EQ((NAS2D::Vector{10.0f, 10.0f}), command.rect.size);
+	const auto instances = recording.instances(command);
+	ASSERT_EQ(2u, instances.size());
+	EXPECT_EQ((NAS2D::Point{2.0f, 0.0f}), instances[1].position);
+	EXPECT_EQ((NAS2D::Rectangle<float>{{2, 0}, {2, 2}}), instances[1].subImageRect);
+
+	recording.clear();
+	EXPECT_EQ(3u, layer.draw(recording, {0, 0}, {{0, 0}, {80, 40}}));
+	EXPECT_EQ(3u, recording.count(CommandType::DrawImageInstances));
+
+	recording.clear();
+	EXPECT_EQ(0u, layer.draw(recording, {-100, 0}, {{0, 0}, {20, 20}}));
+}
+
+TEST(TileMapLayer, rebuildsOnlyChangedChunks) {
+	uint32_t buffer[2 * 2]{};
+	const auto tileset = NAS2D::Image{&buffer, 4, {2, 2}};
+	NAS2D::TileMapLayer layer{tileset, {2, 2}, {64, 64}};
+	EXPECT_EQ(16u, layer.dirtyChunkCount());
+
+	NAS2D::RendererRecording recording;
+	layer.draw(recording, {0, 0}, {{0, 0}, {32, 32}});
+	EXPECT_EQ(15u, layer.dirtyChunkCount());
+
+	layer.draw(recording, {0, 0}, {{0, 0}, {128, 128}});
+	EXPECT_EQ(0u, layer.dirtyChunkCount());
+
+	layer.tile({17, 17}, 0);
+	layer.tile({18, 18}, 0);
+	EXPECT_EQ(1u, layer.dirtyChunkCount());
+	layer.tile({0, 0}, NAS2D::TileMapLayer::NoTile);
+	EXPECT_EQ(1u, layer.dirtyChunkCount());
+
+	layer.fill(0);
+	EXPECT_EQ(16u, layer.dirtyChunkCount());
+}
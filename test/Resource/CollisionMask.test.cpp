@@ -0,0 +1,96 @@
+#include "NAS2D/Resource/CollisionMask.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	NAS2D::CollisionMask filledMask(NAS2D::Vector<int> size) {
+		auto mask = NAS2D::CollisionMask{size};
+		for (int y = 0; y < size.y; ++y)
+		{
+			for (int x = 0; x < size.x; ++x)
+			{
+				mask.solid({x, y}, true);
+			}
+		}
+		return mask;
+	}
+}
+
+
+TEST(CollisionMask, fromPixels) {
+	auto pixels = std::vector<NAS2D::Color>{
+		{0, 0, 0, 0}, {0, 0, 0, 127}, {0, 0, 0, 128},
+		{0, 0, 0, 255}, {0, 0, 0, 1}, {0, 0, 0, 0},
+	};
+	const auto view = NAS2D::ConstPixelView{pixels, {3, 2}, {nullptr, nullptr}};
+
+	const auto mask = NAS2D::CollisionMask{view};
+	EXPECT_EQ((NAS2D::Vector{3, 2}), mask.size());
+	EXPECT_FALSE(mask.solid({0, 0}));
+	EXPECT_FALSE(mask.solid({1, 0}));
+	EXPECT_TRUE(mask.solid({2, 0}));
+	EXPECT_TRUE(mask.solid({0, 1}));
+	EXPECT_FALSE(mask.solid({1, 1}));
+	EXPECT_FALSE(mask.solid({3, 0}));
+	EXPECT_FALSE(mask.solid({-1, 0}));
+
+	const auto anyAlphaMask = NAS2D::CollisionMask{view, 1};
+	EXPECT_TRUE(anyAlphaMask.solid({1, 0}));
+	EXPECT_TRUE(anyAlphaMask.solid({1, 1}));
+
+	const auto areaMask = NAS2D::CollisionMask{view, {{1, 0}, {2, 2}}};
+	EXPECT_EQ((NAS2D::Vector{2, 2}), areaMask.size());
+	EXPECT_TRUE(areaMask.solid({1, 0}));
+	EXPECT_FALSE(areaMask.solid({0, 1}));
+
+	EXPECT_THROW((NAS2D::CollisionMask{view, {{2, 0}, {2, 2}}}), std::runtime_error);
+}
+
+TEST(CollisionMask, solid) {
+	auto mask = NAS2D::CollisionMask{{130, 2}};
+	EXPECT_FALSE(mask.solid({129, 1}));
+	mask.solid({129, 1}, true);
+	mask.solid({64, 0}, true);
+	EXPECT_TRUE(mask.solid({129, 1}));
+	EXPECT_TRUE(mask.solid({64, 0}));
+	EXPECT_FALSE(mask.solid({63, 0}));
+	mask.solid({129, 1}, false);
+	EXPECT_FALSE(mask.solid({129, 1}));
+	EXPECT_THROW(mask.solid({130, 0}, true), std::runtime_error);
+	EXPECT_THROW((NAS2D::CollisionMask{{-1, 1}}), std::runtime_error);
+}
+
+TEST(CollisionMask, overlapsSolidMasks) {
+	const auto mask = filledMask({100, 3});
+	const auto other = filledMask({70, 2});
+	EXPECT_TRUE(mask.overlaps(other, {0, 0}));
+	EXPECT_TRUE(mask.overlaps(other, {99, 2}));
+	EXPECT_TRUE(mask.overlaps(other, {-69, -1}));
+	EXPECT_FALSE(mask.overlaps(other, {100, 0}));
+	EXPECT_FALSE(mask.overlaps(other, {-70, 0}));
+	EXPECT_FALSE(mask.overlaps(other, {0, 3}));
+	EXPECT_FALSE(mask.overlaps(other, {0, -2}));
+	EXPECT_FALSE(mask.overlaps(NAS2D::CollisionMask{{0, 0}}, {0, 0}));
+}
+
+TEST(CollisionMask, overlapsSinglePixels) {
+	auto other = NAS2D::CollisionMask{{90, 3}};
+	other.solid({5, 1}, true);
+
+	// Pixels lined up at every bit position, and missing by one pixel either way
+	for (int x = 0; x < 200; ++x)
+	{
+		auto mask = NAS2D::CollisionMask{{200, 4}};
+		mask.solid({x, 2}, true);
+		for (const auto offsetX : {x - 6, x - 5, x - 4})
+		{
+			EXPECT_EQ(offsetX == x - 5, mask.overlaps(other, {offsetX, 1})) << "x = " << x << ", offset = " << offsetX;
+			EXPECT_EQ(offsetX == x - 5, other.overlaps(mask, {-offsetX, -1})) << "x = " << x << ", offset = " << offsetX;
+		}
+		EXPECT_FALSE(mask.overlaps(other, {x - 5, 0}));
+	}
+}
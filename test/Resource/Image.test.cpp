@@ -1,7 +1,12 @@
 #include "NAS2D/Resource/Image.h"
+#include "NAS2D/Filesystem.h"
+#include "NAS2D/Utility.h"
 
 #include <gtest/gtest.h>
 
+#include <stdexcept>
+#include <utility>
+
 
 TEST(Image, size) {
 	{
@@ -20,3 +25,66 @@ TEST(Image, size) {
 		EXPECT_EQ((NAS2D::Vector{1, 2}), image.size());
 	}
 }
+
+TEST(Image, resized) {
+	uint32_t buffer[4 * 2]{};
+	const auto image = NAS2D::Image{&buffer, 4, {4, 2}};
+	EXPECT_EQ((NAS2D::Vector{2, 1}), image.resized({2, 1}).size());
+	EXPECT_EQ((NAS2D::Vector{8, 3}), image.resized({8, 3}, NAS2D::ResampleFilter::Lanczos).size());
+}
+
+TEST(Image, sampling) {
+	uint32_t buffer[2 * 2]{};
+	auto image = NAS2D::Image{&buffer, 4, {2, 2}};
+	EXPECT_EQ(NAS2D::Image::Mipmaps::None, image.mipmaps());
+	EXPECT_EQ(NAS2D::Image::TextureFilter::Linear, image.textureFilter());
+
+	image.mipmaps(NAS2D::Image::Mipmaps::Cpu);
+	image.textureFilter(NAS2D::Image::TextureFilter::Trilinear);
+	EXPECT_EQ(NAS2D::Image::Mipmaps::Cpu, image.mipmaps());
+	EXPECT_EQ(NAS2D::Image::TextureFilter::Trilinear, image.textureFilter());
+}
+
+TEST(Image, loadAsyncReportsErrorsThroughFuture) {
+	auto& fs = NAS2D::Utility<NAS2D::Filesystem>::init("NAS2DUnitTests", "LairWorks");
+	fs.mount(fs.findInParents(NAS2D::RealPath{"test/data/"}, fs.basePath()));
+
+	auto missing = NAS2D::Image::loadAsync("missingImage.png");
+	auto notAnImage = NAS2D::Image::loadAsync("file.txt");
+	EXPECT_THROW(missing.get(), std::runtime_error);
+	EXPECT_THROW(notAnImage.get(), std::runtime_error);
+
+	NAS2D::Utility<NAS2D::Filesystem>::clear();
+}
+
+TEST(Image, pixels) {
+	auto image = NAS2D::Image{NAS2D::Vector{3, 2}};
+	{
+		const auto pixels = image.editPixels();
+		pixels.fill({{0, 0}, {3, 2}}, NAS2D::Color::Blue);
+		pixels.at({2, 1}) = NAS2D::Color::Red;
+	}
+
+	EXPECT_EQ(NAS2D::Color::Blue, image.pixelColor({0, 0}));
+	EXPECT_EQ(NAS2D::Color::Red, image.pixelColor({2, 1}));
+
+	const auto pixels = std::as_const(image).pixels();
+	EXPECT_EQ((NAS2D::Vector{3, 2}), pixels.size());
+	EXPECT_EQ(6u, pixels.pixels().size());
+	EXPECT_EQ(NAS2D::Color::Red, pixels.row(1)[2]);
+	EXPECT_THROW(pixels.at({3, 0}), std::runtime_error);
+}
+
+TEST(Image, collisionMask) {
+	auto image = NAS2D::Image{NAS2D::Vector{2, 1}};
+	image.editPixels().at({1, 0}) = NAS2D::Color::White;
+
+	const auto& mask = image.collisionMask();
+	EXPECT_EQ((NAS2D::Vector{2, 1}), mask.size());
+	EXPECT_FALSE(mask.solid({0, 0}));
+	EXPECT_TRUE(mask.solid({1, 0}));
+	EXPECT_EQ(&mask, &image.collisionMask());
+
+	image.editPixels().at({0, 0}) = NAS2D::Color::White;
+	EXPECT_TRUE(image.collisionMask().solid({0, 0}));
+}
@@ -0,0 +1,63 @@
+#include "NAS2D/Resource/PixelView.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	NAS2D::PixelView viewOf(std::vector<NAS2D::Color>& pixels, NAS2D::Vector<int> size) {
+		return {pixels, size, {nullptr, nullptr}};
+	}
+}
+
+
+TEST(PixelView, rows) {
+	auto pixels = std::vector<NAS2D::Color>{
+		NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue,
+		NAS2D::Color::White, NAS2D::Color::Black, NAS2D::Color::Yellow,
+	};
+	const auto view = viewOf(pixels, {3, 2});
+	EXPECT_EQ(3u, view.row(0).size());
+	EXPECT_EQ(NAS2D::Color::Blue, view.row(0)[2]);
+	EXPECT_EQ(NAS2D::Color::White, view.row(1)[0]);
+	EXPECT_EQ(NAS2D::Color::Yellow, view.at({2, 1}));
+	EXPECT_THROW(view.row(2), std::runtime_error);
+	EXPECT_THROW(view.row(-1), std::runtime_error);
+	EXPECT_THROW(view.at({0, 2}), std::runtime_error);
+}
+
+TEST(PixelView, readArea) {
+	auto pixels = std::vector<NAS2D::Color>{
+		NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue,
+		NAS2D::Color::White, NAS2D::Color::Black, NAS2D::Color::Yellow,
+	};
+	const auto view = viewOf(pixels, {3, 2});
+	EXPECT_EQ((std::vector{NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::Black, NAS2D::Color::Yellow}), view.read({{1, 0}, {2, 2}}));
+	EXPECT_EQ(pixels, view.read({{0, 0}, {3, 2}}));
+	EXPECT_TRUE(view.read({{1, 1}, {0, 0}}).empty());
+	EXPECT_THROW(view.read({{2, 0}, {2, 1}}), std::runtime_error);
+
+	auto tooSmall = std::vector<NAS2D::Color>(3);
+	EXPECT_THROW(view.read({{0, 0}, {2, 2}}, tooSmall), std::runtime_error);
+}
+
+TEST(PixelView, writeArea) {
+	auto pixels = std::vector<NAS2D::Color>(3 * 2, NAS2D::Color::Black);
+	const auto view = viewOf(pixels, {3, 2});
+	view.write({{1, 0}, {2, 2}}, std::vector{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White});
+	EXPECT_EQ((std::vector{
+		NAS2D::Color::Black, NAS2D::Color::Red, NAS2D::Color::Green,
+		NAS2D::Color::Black, NAS2D::Color::Blue, NAS2D::Color::White,
+	}), pixels);
+
+	view.fill({{0, 1}, {2, 1}}, NAS2D::Color::Yellow);
+	EXPECT_EQ((std::vector{
+		NAS2D::Color::Black, NAS2D::Color::Red, NAS2D::Color::Green,
+		NAS2D::Color::Yellow, NAS2D::Color::Yellow, NAS2D::Color::White,
+	}), pixels);
+
+	EXPECT_THROW(view.write({{0, 0}, {1, 1}}, std::vector<NAS2D::Color>{}), std::runtime_error);
+	EXPECT_THROW(view.fill({{0, 0}, {4, 1}}, NAS2D::Color::Red), std::runtime_error);
+}
@@ -0,0 +1,68 @@
+#include "NAS2D/Resource/SkylinePacker.h"
+#include "NAS2D/Math/Rectangle.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+
+TEST(SkylinePacker, insertPlacesBottomLeft) {
+	NAS2D::SkylinePacker packer{{8, 8}};
+
+	EXPECT_EQ((NAS2D::Point{0, 0}), packer.insert({4, 2}));
+	EXPECT_EQ((NAS2D::Point{4, 0}), packer.insert({4, 4}));
+	EXPECT_EQ((NAS2D::Point{0, 2}), packer.insert({4, 2}));
+	EXPECT_EQ((NAS2D::Point{0, 4}), packer.insert({8, 4}));
+}
+
+TEST(SkylinePacker, insertRejectsWhatDoesNotFit) {
+	NAS2D::SkylinePacker packer{{8, 8}};
+
+	EXPECT_EQ(std::nullopt, packer.insert({9, 1}));
+	EXPECT_EQ(std::nullopt, packer.insert({1, 9}));
+	EXPECT_EQ(std::nullopt, packer.insert({0, 1}));
+
+	EXPECT_NE(std::nullopt, packer.insert({8, 6}));
+	EXPECT_EQ(std::nullopt, packer.insert({8, 3}));
+	EXPECT_NE(std::nullopt, packer.insert({8, 2}));
+	EXPECT_EQ(std::nullopt, packer.insert({1, 1}));
+}
+
+TEST(SkylinePacker, insertedRectanglesDoNotOverlap) {
+	NAS2D::SkylinePacker packer{{64, 64}};
+	std::vector<NAS2D::Rectangle<int>> placed;
+
+	for (int i = 0; i < 64; ++i)
+	{
+		const auto size = NAS2D::Vector{1 + (i * 7) % 13, 1 + (i * 5) % 11};
+		const auto position = packer.insert(size);
+		if (!position) { continue; }
+
+		const auto rect = NAS2D::Rectangle{*position, size};
+		EXPECT_TRUE((NAS2D::Rectangle<int>{{0, 0}, {64, 64}}.contains(rect)));
+		for (const auto& other : placed)
+		{
+			EXPECT_FALSE(rect.overlaps(other));
+		}
+		placed.push_back(rect);
+	}
+
+	EXPECT_FALSE(placed.empty());
+}
+
+TEST(SkylinePacker, areaStatistics) {
+	NAS2D::SkylinePacker packer{{8, 8}};
+	EXPECT_EQ(0, packer.usedArea());
+	EXPECT_EQ(0, packer.wastedArea());
+	EXPECT_EQ(0.0f, packer.occupancy());
+
+	packer.insert({4, 4});
+	EXPECT_EQ(16, packer.usedArea());
+	EXPECT_EQ(0, packer.wastedArea());
+	EXPECT_EQ(0.25f, packer.occupancy());
+
+	// Too wide to fit beside the first, leaving space under it unreachable
+	packer.insert({6, 2});
+	EXPECT_EQ(28, packer.usedArea());
+	EXPECT_EQ(8, packer.wastedArea());
+}
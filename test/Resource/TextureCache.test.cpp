@@ -0,0 +1,104 @@
+#include "NAS2D/Resource/TextureCache.h"
+#include "NAS2D/Resource/Image.h"
+#include "NAS2D/Filesystem.h"
+#include "NAS2D/Utility.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+
+namespace {
+	class TextureCache : public ::testing::Test {
+	protected:
+		TextureCache() :
+			fs{NAS2D::Utility<NAS2D::Filesystem>::init("NAS2DUnitTests", "LairWorks")},
+			cacheDirectory{(std::filesystem::temp_directory_path() / "NAS2DTextureCacheTest").string()},
+			cache{NAS2D::RealPath{cacheDirectory}}
+		{
+			fs.mountReadWrite(fs.prefPath());
+			fs.writeFile(SourcePath, "Source image data");
+		}
+
+		~TextureCache() override {
+			fs.del(SourcePath);
+			std::filesystem::remove_all(cacheDirectory);
+			NAS2D::Utility<NAS2D::Filesystem>::clear();
+		}
+
+		const NAS2D::VirtualPath SourcePath{"TextureCacheSource.png"};
+		const std::vector<NAS2D::Color> pixels{NAS2D::Color::Red, NAS2D::Color::Green, NAS2D::Color::Blue, NAS2D::Color::White, NAS2D::Color::Black, NAS2D::Color::Yellow};
+
+		NAS2D::Filesystem& fs;
+		std::string cacheDirectory;
+		NAS2D::TextureCache cache;
+	};
+}
+
+
+TEST_F(TextureCache, disabledByDefault) {
+	const auto disabledCache = NAS2D::TextureCache{};
+	EXPECT_FALSE(disabledCache.enabled());
+	EXPECT_FALSE(disabledCache.store(SourcePath, "Source image data", pixels, {3, 2}));
+	EXPECT_FALSE(disabledCache.find(SourcePath).has_value());
+}
+
+TEST_F(TextureCache, storeAndFind) {
+	EXPECT_TRUE(cache.enabled());
+	EXPECT_FALSE(cache.find(SourcePath).has_value());
+	EXPECT_THROW(cache.store(SourcePath, "Source image data", pixels, {2, 2}), std::runtime_error);
+
+	ASSERT_TRUE(cache.store(SourcePath, "Source image data", pixels, {3, 2}));
+	auto entry = cache.find(SourcePath);
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_EQ((NAS2D::Vector{3, 2}), entry->size);
+	EXPECT_TRUE(std::equal(pixels.begin(), pixels.end(), entry->pixels.begin(), entry->pixels.end()));
+
+	// Writes to entry pixels are not saved
+	entry->pixels[0] = NAS2D::Color::Navy;
+	EXPECT_EQ(NAS2D::Color::Red, cache.find(SourcePath)->pixels[0]);
+}
+
+TEST_F(TextureCache, findByContent) {
+	ASSERT_TRUE(cache.store(SourcePath, "Source image data", pixels, {3, 2}));
+	EXPECT_TRUE(cache.find(SourcePath, "Source image data").has_value());
+	EXPECT_FALSE(cache.find(SourcePath, "Other image data!").has_value());
+}
+
+TEST_F(TextureCache, touchedSourceFoundByContent) {
+	ASSERT_TRUE(cache.store(SourcePath, "Source image data", pixels, {3, 2}));
+	const auto sourceFile = std::filesystem::path{fs.prefPath().string()} / SourcePath.string();
+	std::filesystem::last_write_time(sourceFile, std::filesystem::last_write_time(sourceFile) + std::chrono::hours{1});
+	EXPECT_FALSE(cache.find(SourcePath).has_value());
+
+	const auto entry = cache.find(SourcePath, "Source image data");
+	ASSERT_TRUE(entry.has_value());
+	EXPECT_EQ(NAS2D::Color::Red, entry->pixels[0]);
+
+	// Stored again with the new modification time, leaving the found entry intact
+	const auto entryByPath = cache.find(SourcePath);
+	ASSERT_TRUE(entryByPath.has_value());
+	EXPECT_TRUE(std::equal(pixels.begin(), pixels.end(), entryByPath->pixels.begin(), entryByPath->pixels.end()));
+	EXPECT_EQ(NAS2D::Color::Yellow, entry->pixels[5]);
+}
+
+TEST_F(TextureCache, changedSourceIsStale) {
+	ASSERT_TRUE(cache.store(SourcePath, "Source image data", pixels, {3, 2}));
+	fs.writeFile(SourcePath, "Changed source image data");
+	EXPECT_FALSE(cache.find(SourcePath).has_value());
+}
+
+TEST_F(TextureCache, imageLoadsFromCache) {
+	NAS2D::Utility<NAS2D::TextureCache>::init(NAS2D::RealPath{cacheDirectory});
+	ASSERT_TRUE(cache.store(SourcePath, "Source image data", pixels, {3, 2}));
+
+	const auto image = NAS2D::Image{SourcePath.string()};
+	EXPECT_EQ((NAS2D::Vector{3, 2}), image.size());
+	EXPECT_EQ(NAS2D::Color::Red, image.pixelColor({0, 0}));
+	EXPECT_EQ(NAS2D::Color::Yellow, image.pixelColor({2, 1}));
+
+	NAS2D::Utility<NAS2D::TextureCache>::clear();
+}
@@ -0,0 +1,78 @@
+#include "NAS2D/ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+
+TEST(ThreadPool, rejectsZeroThreads) {
+	EXPECT_THROW(NAS2D::ThreadPool{0}, std::runtime_error);
+}
+
+TEST(ThreadPool, submitReturnsResult) {
+	NAS2D::ThreadPool pool{2};
+	EXPECT_EQ(2u, pool.threadCount());
+
+	auto future1 = pool.submit([]() { return 6 * 7; });
+	auto future2 = pool.submit([]() {});
+	EXPECT_EQ(42, future1.get());
+	EXPECT_NO_THROW(future2.get());
+}
+
+TEST(ThreadPool, submitPropagatesExceptions) {
+	NAS2D::ThreadPool pool{1};
+	auto future = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+	EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, destructorFinishesQueuedTasks) {
+	std::atomic<int> counter{0};
+	{
+		NAS2D::ThreadPool pool{2};
+		for (int i = 0; i < 100; ++i)
+		{
+			pool.submit([&counter]() { ++counter; });
+		}
+	}
+	EXPECT_EQ(100, counter);
+}
+
+TEST(ThreadPool, parallelForCoversRangeOnce) {
+	NAS2D::ThreadPool pool{3};
+
+	for (std::size_t count : {0u, 1u, 2u, 7u, 1000u})
+	{
+		std::vector<int> visits(count, 0);
+		pool.parallelFor(count, [&visits](std::size_t begin, std::size_t end) {
+			for (auto i = begin; i < end; ++i) { ++visits[i]; }
+		});
+		EXPECT_EQ(static_cast<int>(count), std::accumulate(visits.begin(), visits.end(), 0));
+		EXPECT_EQ(visits.end(), std::find_if(visits.begin(), visits.end(), [](int visitCount) { return visitCount != 1; }));
+	}
+}
+
+TEST(ThreadPool, parallelForNested) {
+	NAS2D::ThreadPool pool{2};
+	std::atomic<int> counter{0};
+
+	pool.parallelFor(8, [&pool, &counter](std::size_t begin, std::size_t end) {
+		for (auto i = begin; i < end; ++i)
+		{
+			pool.parallelFor(8, [&counter](std::size_t innerBegin, std::size_t innerEnd) {
+				counter += static_cast<int>(innerEnd - innerBegin);
+			});
+		}
+	});
+	EXPECT_EQ(64, counter);
+}
+
+TEST(ThreadPool, parallelForRethrows) {
+	NAS2D::ThreadPool pool{2};
+	EXPECT_THROW(pool.parallelFor(10, [](std::size_t begin, std::size_t) {
+		if (begin > 0) { throw std::runtime_error("chunk failed"); }
+	}), std::runtime_error);
+}